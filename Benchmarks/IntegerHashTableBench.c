@@ -0,0 +1,255 @@
+/*
+ * IntegerHashTableBench.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// IntegerHashTable against the chained table it replaced, kept
+// here as the baseline. Keys look like uniform names. Build and
+// run with "make bench-hashtable".
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "IntegerHashTable.h"
+
+#define BENCH_OPERATIONS 200000
+
+typedef struct ChainedBucket
+{
+	char* Key;
+	int Value;
+	struct ChainedBucket* NextBucket;
+	
+} ChainedBucket;
+
+typedef struct ChainedHashTable
+{
+	size_t TableMax;
+	ChainedBucket** Table;
+	
+} ChainedHashTable;
+
+static size_t ChainedHashTable_HashFunction(ChainedHashTable* This, char* Key)
+{
+	size_t Len = strlen(Key);
+	size_t HashValue = 0;
+	
+	for(size_t CharID = 0; CharID < Len; CharID++)
+	{
+		HashValue = ((HashValue << 6) ^ (HashValue >> 2) ^ Key[CharID]) % This->TableMax;
+	}
+	
+	return HashValue;
+}
+
+static ChainedBucket* ChainedHashTable_Lookup(ChainedHashTable* This, char* Key)
+{
+	ChainedBucket* Cursor = This->Table[ChainedHashTable_HashFunction(This, Key)];
+	
+	while (Cursor != NULL && strcmp(Key, Cursor->Key) != 0)
+	{
+		Cursor = Cursor->NextBucket;
+	}
+	
+	return Cursor;
+}
+
+static void ChainedHashTable_Add(ChainedHashTable* This, char* Key, int Value)
+{
+	if (ChainedHashTable_Lookup(This, Key) == NULL)
+	{
+		ChainedBucket* NewBucket = calloc(1, sizeof(ChainedBucket));
+		size_t Index = ChainedHashTable_HashFunction(This, Key);
+		
+		NewBucket->Key = strdup(Key);
+		NewBucket->Value = Value;
+		NewBucket->NextBucket = This->Table[Index];
+		This->Table[Index] = NewBucket;
+	}
+}
+
+static void ChainedHashTable_Wipeout(ChainedHashTable* This)
+{
+	for (size_t Index = 0; Index < This->TableMax; Index++)
+	{
+		ChainedBucket* Cursor = This->Table[Index];
+		
+		while (Cursor != NULL)
+		{
+			ChainedBucket* Temp = Cursor;
+			Cursor = Cursor->NextBucket;
+			free(Temp->Key);
+			free(Temp);
+		}
+	}
+	
+	free(This->Table);
+}
+
+static double Bench_Now(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return Time.tv_sec * 1e9 + Time.tv_nsec;
+}
+
+static char** Bench_MakeKeys(int Count, const char* Prefix)
+{
+	char** Keys = malloc(sizeof(char*) * Count);
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		char Key[64];
+		snprintf(Key, sizeof(Key), "%s[%d].Value", Prefix, Index);
+		Keys[Index] = strdup(Key);
+	}
+	
+	return Keys;
+}
+
+static void Bench_Run(int Count)
+{
+	char** Keys = Bench_MakeKeys(Count, "u_Lights");
+	char** Misses = Bench_MakeKeys(Count, "u_Shadows");
+	uint32_t* Hashes = malloc(sizeof(uint32_t) * Count);
+	double Start, InsertChained = 0, InsertOpen = 0, HitChained = 0, HitOpen = 0, HitHashed = 0, MissChained = 0, MissOpen = 0;
+	long Checksum = 0;
+	int Rounds = BENCH_OPERATIONS / Count;
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		Hashes[Index] = IntegerHashTable_Hash(Keys[Index]);
+	}
+	
+	for (int Round = 0; Round < Rounds; Round++)
+	{
+		// The old table was sized once at init, ShaderProgram used 32.
+		
+		ChainedHashTable Chained = {32, calloc(32, sizeof(ChainedBucket*))};
+		IntegerHashTable Open;
+		
+		IntegerHashTable_Init(&Open, 32);
+		
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			ChainedHashTable_Add(&Chained, Keys[Index], Index);
+		}
+		
+		InsertChained += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Open.AddBucket(&Open, Keys[Index], Index);
+		}
+		
+		InsertOpen += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Checksum += ChainedHashTable_Lookup(&Chained, Keys[Index])->Value;
+		}
+		
+		HitChained += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Open.LookupBucket(&Open, Keys[Index]);
+			Checksum -= Open.GetBucketValue(&Open);
+		}
+		
+		HitOpen += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Open.LookupBucketHashed(&Open, Keys[Index], Hashes[Index]);
+			Checksum += Open.GetBucketValue(&Open);
+		}
+		
+		HitHashed += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Checksum += ChainedHashTable_Lookup(&Chained, Misses[Index]) != NULL;
+		}
+		
+		MissChained += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Checksum += Open.LookupBucket(&Open, Misses[Index]);
+		}
+		
+		MissOpen += Bench_Now() - Start;
+		
+		ChainedHashTable_Wipeout(&Chained);
+		Open.Wipeout(&Open);
+	}
+	
+	double Operations = (double) Count * Rounds;
+	
+	printf("%6d keys | insert %7.1f %7.1f | hit %7.1f %7.1f hashed %7.1f | miss %7.1f %7.1f ns/op\n", Count,
+		   InsertChained / Operations, InsertOpen / Operations,
+		   HitChained / Operations, HitOpen / Operations, HitHashed / Operations,
+		   MissChained / Operations, MissOpen / Operations);
+	
+	if (Checksum != (long) Count * (Count - 1) / 2 * Rounds)
+	{
+		printf("Checksum mismatch ! : %ld\n", Checksum);
+	}
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		free(Keys[Index]);
+		free(Misses[Index]);
+	}
+	
+	free(Keys);
+	free(Misses);
+	free(Hashes);
+}
+
+int main(int argc, char** argv)
+{
+	int Counts[] = {16, 64, 256, 1024, 4096};
+	
+	printf("         chained vs open addressing\n");
+	
+	for (size_t Index = 0; Index < sizeof(Counts) / sizeof(Counts[0]); Index++)
+	{
+		Bench_Run(Counts[Index]);
+	}
+	
+	return EXIT_SUCCESS;
+}
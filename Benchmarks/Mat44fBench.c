@@ -0,0 +1,421 @@
+/*
+ * Mat44fBench.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Every Mat44f backend the CPU supports against the scalar one,
+// over a scene of object matrices, through the public Mat44f
+// functions. The results are first checked against the scalar
+// kernels. The batch entry points are then timed against the
+// same work done one call at a time, on a point cloud, with and
+// without the worker threads. Build and run with
+// "make bench-mat44f".
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Mat44f.h"
+#include "Mat44fBackend.h"
+#include "Mat44fBatch.h"
+
+#define BENCH_OBJECTS 32768
+#define BENCH_ROUNDS 32
+#define BENCH_INVERSE_TOLERANCE 0.0001f
+#define BENCH_POINTS (1 << 20)
+#define BENCH_BATCH_ROUNDS 8
+
+typedef struct BenchScene
+{
+	Mat44f Parent;
+	Mat44f* Locals;
+	Mat44f* Worlds;
+	Mat44f* Inverses;
+	Vec4f* Points;
+	Vec4f* Transformed;
+	
+	Vec3f* Cloud;
+	Vec3f* NewCloud;
+	float* X;
+	float* Y;
+	float* Z;
+	float* NewX;
+	float* NewY;
+	float* NewZ;
+	float* NewW;
+	
+} BenchScene;
+
+static double Bench_Now(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return Time.tv_sec * 1e9 + Time.tv_nsec;
+}
+
+static float Bench_Random(float Min, float Max)
+{
+	return Min + (Max - Min) * ((float) rand() / (float) RAND_MAX);
+}
+
+// Translation * RotateZ * RotateY * RotateX * Scale, built with
+// the scalar kernels only.
+
+static void Bench_MakeObject(Mat44f* This)
+{
+	Mat44f Transform;
+	
+	Mat44f_TranslationEx(This, Bench_Random(-100.0f, 100.0f), Bench_Random(-100.0f, 100.0f), Bench_Random(-100.0f, 100.0f));
+	
+	Mat44f_RotateZ(&Transform, Bench_Random(-3.14f, 3.14f));
+	Mat44f_MultiplyScalar(This, &Transform);
+	
+	Mat44f_RotateY(&Transform, Bench_Random(-3.14f, 3.14f));
+	Mat44f_MultiplyScalar(This, &Transform);
+	
+	Mat44f_RotateX(&Transform, Bench_Random(-3.14f, 3.14f));
+	Mat44f_MultiplyScalar(This, &Transform);
+	
+	Mat44f_ScaleEx(&Transform, Bench_Random(0.5f, 2.0f), Bench_Random(0.5f, 2.0f), Bench_Random(0.5f, 2.0f));
+	Mat44f_MultiplyScalar(This, &Transform);
+}
+
+static void Bench_MakeScene(BenchScene* This)
+{
+	This->Locals = malloc(sizeof(Mat44f) * BENCH_OBJECTS);
+	This->Worlds = malloc(sizeof(Mat44f) * BENCH_OBJECTS);
+	This->Inverses = malloc(sizeof(Mat44f) * BENCH_OBJECTS);
+	This->Points = malloc(sizeof(Vec4f) * BENCH_OBJECTS);
+	This->Transformed = malloc(sizeof(Vec4f) * BENCH_OBJECTS);
+	This->Cloud = malloc(sizeof(Vec3f) * BENCH_POINTS);
+	This->NewCloud = malloc(sizeof(Vec3f) * BENCH_POINTS);
+	This->X = malloc(sizeof(float) * BENCH_POINTS * 7);
+	
+	if (This->Locals == NULL || This->Worlds == NULL || This->Inverses == NULL || This->Points == NULL || This->Transformed == NULL ||
+		This->Cloud == NULL || This->NewCloud == NULL || This->X == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+	
+	This->Y = This->X + BENCH_POINTS;
+	This->Z = This->Y + BENCH_POINTS;
+	This->NewX = This->Z + BENCH_POINTS;
+	This->NewY = This->NewX + BENCH_POINTS;
+	This->NewZ = This->NewY + BENCH_POINTS;
+	This->NewW = This->NewZ + BENCH_POINTS;
+	
+	srand(1234);
+	Bench_MakeObject(&This->Parent);
+	
+	for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+	{
+		Bench_MakeObject(&This->Locals[Index]);
+		This->Points[Index] = (Vec4f) {Bench_Random(-10.0f, 10.0f), Bench_Random(-10.0f, 10.0f), Bench_Random(-10.0f, 10.0f), 1.0f};
+	}
+	
+	for (int Index = 0; Index < BENCH_POINTS; Index++)
+	{
+		This->Cloud[Index] = (Vec3f) {Bench_Random(-50.0f, 50.0f), Bench_Random(-50.0f, 50.0f), Bench_Random(-50.0f, 50.0f)};
+		This->X[Index] = This->Cloud[Index].X;
+		This->Y[Index] = This->Cloud[Index].Y;
+		This->Z[Index] = This->Cloud[Index].Z;
+	}
+}
+
+static void Bench_WipeScene(BenchScene* This)
+{
+	free(This->Locals);
+	free(This->Worlds);
+	free(This->Inverses);
+	free(This->Points);
+	free(This->Transformed);
+	free(This->Cloud);
+	free(This->NewCloud);
+	free(This->X);
+}
+
+static float Bench_MaxDifference(float* A, float* B, int Count, int IsRelative)
+{
+	float Difference = 0.0f;
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		float Error = fabsf(A[Index] - B[Index]);
+		
+		if (IsRelative)
+		{
+			Error /= fmaxf(1.0f, fabsf(B[Index]));
+		}
+		
+		Difference = fmaxf(Difference, Error);
+	}
+	
+	return Difference;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns FALSE if a kernel of the current backend is off.
+
+static int Bench_Check(BenchScene* This)
+{
+	float MultiplyError = 0.0f, InverseError = 0.0f, TransposeError = 0.0f, VectorError = 0.0f;
+	
+	for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+	{
+		Mat44f Expected = This->Parent, Result = This->Parent;
+		Mat44f ExpectedInverse, ResultInverse;
+		Vec4f ExpectedPoint, ResultPoint;
+		
+		Mat44f_MultiplyScalar(&Expected, &This->Locals[Index]);
+		Mat44f_Multiply(&Result, &This->Locals[Index]);
+		MultiplyError = fmaxf(MultiplyError, Bench_MaxDifference((float*) &Result, (float*) &Expected, 16, 0));
+		
+		Mat44f_InverseScalar(&Expected, &ExpectedInverse);
+		Mat44f_Inverse(&Expected, &ResultInverse);
+		InverseError = fmaxf(InverseError, Bench_MaxDifference((float*) &ResultInverse, (float*) &ExpectedInverse, 16, 1));
+		
+		Mat44f_ProductMatrixVectorScalar(&Expected, &This->Points[Index], &ExpectedPoint);
+		Mat44f_ProductMatrixVector(&Expected, &This->Points[Index], &ResultPoint);
+		VectorError = fmaxf(VectorError, Bench_MaxDifference((float*) &ResultPoint, (float*) &ExpectedPoint, 4, 0));
+		
+		Result = Expected;
+		Mat44f_TransposeScalar(&Expected);
+		Mat44f_Transpose(&Result);
+		TransposeError = fmaxf(TransposeError, Bench_MaxDifference((float*) &Result, (float*) &Expected, 16, 0));
+	}
+	
+	printf("%-8s | error multiply %g inverse %g transpose %g vector %g\n", Mat44fBackend_GetName(), MultiplyError, InverseError, TransposeError, VectorError);
+	
+	return MultiplyError == 0.0f && TransposeError == 0.0f && VectorError == 0.0f && InverseError <= BENCH_INVERSE_TOLERANCE;
+}
+
+static void Bench_Run(BenchScene* This)
+{
+	double Start, Multiply = 0, Inverse = 0, Affine = 0, Transpose = 0, Vector = 0;
+	float Checksum = 0.0f;
+	
+	for (int Round = 0; Round < BENCH_ROUNDS; Round++)
+	{
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			This->Worlds[Index] = This->Parent;
+			Mat44f_Multiply(&This->Worlds[Index], &This->Locals[Index]);
+		}
+		
+		Multiply += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			Mat44f_Inverse(&This->Worlds[Index], &This->Inverses[Index]);
+		}
+		
+		Inverse += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		// The objects are affine, the scalar fast path needs no backend.
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			Mat44f_InverseAffine(&This->Worlds[Index], &This->Inverses[Index]);
+		}
+		
+		Affine += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			Mat44f_ProductMatrixVector(&This->Worlds[Index], &This->Points[Index], &This->Transformed[Index]);
+		}
+		
+		Vector += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			Mat44f_Transpose(&This->Inverses[Index]);
+		}
+		
+		Transpose += Bench_Now() - Start;
+		
+		Checksum += This->Inverses[Round].e14 + This->Transformed[Round].X;
+	}
+	
+	double Operations = (double) BENCH_OBJECTS * BENCH_ROUNDS;
+	
+	printf("%-8s | multiply %6.2f | inverse %6.2f affine %6.2f | transpose %6.2f | vector %6.2f ns/op (%g)\n", Mat44fBackend_GetName(),
+		   Multiply / Operations, Inverse / Operations, Affine / Operations, Transpose / Operations, Vector / Operations, Checksum);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The batch results must be the bits of the one call at a time
+// scalar code, whatever the backend and the threads count.
+
+static int Bench_CheckBatch(BenchScene* This)
+{
+	Mat44f View = This->Locals[0];
+	Mat44f Projection;
+	int IsValid = 1;
+	
+	Mat44f_Perspective(&Projection, 1.0f, 1.5f, 0.1f, 1000.0f);
+	
+	Mat44fBatch_ModelViewProjection(&Projection, &View, This->Locals, This->Worlds, BENCH_OBJECTS);
+	Mat44fBatch_TransformPoints(&This->Parent, This->Cloud, This->NewCloud, BENCH_POINTS);
+	Mat44fBatch_TransformPointsSoA(&This->Parent, This->X, This->Y, This->Z, This->NewX, This->NewY, This->NewZ, This->NewW, BENCH_POINTS);
+	
+	Mat44f ProjectionView = Projection;
+	Mat44f_MultiplyScalar(&ProjectionView, &View);
+	
+	for (int Index = 0; Index < BENCH_OBJECTS && IsValid; Index++)
+	{
+		Mat44f Expected = ProjectionView;
+		
+		Mat44f_MultiplyScalar(&Expected, &This->Locals[Index]);
+		IsValid = Bench_MaxDifference((float*) &This->Worlds[Index], (float*) &Expected, 16, 0) == 0.0f;
+	}
+	
+	for (int Index = 0; Index < BENCH_POINTS && IsValid; Index++)
+	{
+		Vec4f Point = {This->X[Index], This->Y[Index], This->Z[Index], 1.0f};
+		Vec4f Expected;
+		
+		Mat44f_ProductMatrixVectorScalar(&This->Parent, &Point, &Expected);
+		
+		IsValid = This->NewCloud[Index].X == Expected.X && This->NewCloud[Index].Y == Expected.Y && This->NewCloud[Index].Z == Expected.Z &&
+				  This->NewX[Index] == Expected.X && This->NewY[Index] == Expected.Y && This->NewZ[Index] == Expected.Z && This->NewW[Index] == Expected.W;
+	}
+	
+	if (!IsValid)
+	{
+		printf("%-8s | batch results differ with %d threads !\n", Mat44fBackend_GetName(), Mat44fBatch_GetThreads());
+	}
+	
+	return IsValid;
+}
+
+static void Bench_RunBatch(BenchScene* This)
+{
+	double Start, Single = 0, Batch = 0, PointsSingle = 0, PointsAoS = 0, PointsSoA = 0;
+	
+	for (int Round = 0; Round < BENCH_BATCH_ROUNDS; Round++)
+	{
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_OBJECTS; Index++)
+		{
+			This->Worlds[Index] = This->Parent;
+			Mat44f_Multiply(&This->Worlds[Index], &This->Locals[Index]);
+		}
+		
+		Single += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		Mat44fBatch_MultiplyArray(&This->Parent, This->Locals, This->Worlds, BENCH_OBJECTS);
+		
+		Batch += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		for (int Index = 0; Index < BENCH_POINTS; Index++)
+		{
+			Mat44f_ApplyTransformation(&This->Parent, &This->Cloud[Index], &This->NewCloud[Index], 0);
+		}
+		
+		PointsSingle += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		Mat44fBatch_TransformPoints(&This->Parent, This->Cloud, This->NewCloud, BENCH_POINTS);
+		
+		PointsAoS += Bench_Now() - Start;
+		Start = Bench_Now();
+		
+		Mat44fBatch_TransformPointsSoA(&This->Parent, This->X, This->Y, This->Z, This->NewX, This->NewY, This->NewZ, NULL, BENCH_POINTS);
+		
+		PointsSoA += Bench_Now() - Start;
+	}
+	
+	double Objects = (double) BENCH_OBJECTS * BENCH_BATCH_ROUNDS;
+	double Points = (double) BENCH_POINTS * BENCH_BATCH_ROUNDS;
+	
+	printf("%-8s %2d | multiply %5.2f batch %5.2f | points %5.2f AoS %5.2f SoA %5.2f ns/op\n", Mat44fBackend_GetName(), Mat44fBatch_GetThreads(),
+		   Single / Objects, Batch / Objects, PointsSingle / Points, PointsAoS / Points, PointsSoA / Points);
+}
+
+int main(int argc, char** argv)
+{
+	BenchScene Scene;
+	int IsValid = 1;
+	
+	Bench_MakeScene(&Scene);
+	
+	for (int BackendID = MAT_44F_BACKEND_SCALAR + 1; BackendID < MAT_44F_BACKEND_MAX; BackendID++)
+	{
+		if (Mat44fBackend_Select(BackendID))
+		{
+			IsValid &= Bench_Check(&Scene);
+		}
+	}
+	
+	printf("%d objects, %d rounds\n", BENCH_OBJECTS, BENCH_ROUNDS);
+	
+	for (int BackendID = MAT_44F_BACKEND_SCALAR; BackendID < MAT_44F_BACKEND_MAX; BackendID++)
+	{
+		if (Mat44fBackend_Select(BackendID))
+		{
+			Bench_Run(&Scene);
+		}
+	}
+	
+	long CPUs = sysconf(_SC_NPROCESSORS_ONLN);
+	int ThreadsCounts[2] = {1, CPUs > 1 ? (int) CPUs : 2};
+	
+	printf("%d objects, %d points, %d rounds, one call at a time against batches\n", BENCH_OBJECTS, BENCH_POINTS, BENCH_BATCH_ROUNDS);
+	
+	for (int Threads = 0; Threads < 2; Threads++)
+	{
+		Mat44fBatch_SetThreads(ThreadsCounts[Threads]);
+		
+		for (int BackendID = MAT_44F_BACKEND_SCALAR; BackendID < MAT_44F_BACKEND_MAX; BackendID++)
+		{
+			if (Mat44fBackend_Select(BackendID))
+			{
+				IsValid &= Bench_CheckBatch(&Scene);
+				Bench_RunBatch(&Scene);
+			}
+		}
+	}
+	
+	Mat44fBatch_SetThreads(1);
+	
+	Mat44fBackend_SelectBest();
+	printf("Default backend : %s\n", Mat44fBackend_GetName());
+	
+	Bench_WipeScene(&Scene);
+	
+	return IsValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
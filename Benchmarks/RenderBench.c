@@ -0,0 +1,560 @@
+/*
+ * RenderBench.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Runs the RenderingEngine headless through scripted camera
+// paths (orbit, pan and zoom) in every ViewName alone, then in
+// the 4 views layout, at a few resolutions. The cameras are
+// driven through the CameraControl dragging and forwarding
+// methods, every run starts from the default view and a frame
+// is a fixed step of the path, so two runs render the same
+// frames. Reports the frames per second, the CPU and GPU time
+// per viewport and the peak memory of the engine targets as
+// JSON. Build and run with "make bench".
+//
+// The views are rendered one RenderingEngine_Render() call at
+// a time to be timed one by one. The 4 views layout is run a
+// second time through RenderingEngine_RenderViews(), timed as
+// a whole.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HeadlessRenderer.h"
+#include "Mat44fBackend.h"
+
+#define BENCH_FRAMES 60
+#define BENCH_WARMUP_FRAMES 5
+#define BENCH_RESOLUTIONS_MAX 8
+#define BENCH_ZOOM_DISTANCE 20.0f
+
+typedef enum
+{
+	BENCH_PATH_ORBIT,
+	BENCH_PATH_PAN,
+	BENCH_PATH_ZOOM,
+	BENCH_PATH_MAX
+} BenchPath;
+
+typedef enum
+{
+	BENCH_SUBMIT_PER_VIEW,
+	BENCH_SUBMIT_BATCHED
+} BenchSubmit;
+
+static const char* BenchPathNames[BENCH_PATH_MAX] = {"orbit", "pan", "zoom"};
+static const char* BenchViewNames[VIEW_MAX] = {"perspective", "front", "back", "top", "bottom", "left", "right"};
+static const char* BenchViewportNames[VIEW_VIEWPORT_MAX] = {"A", "B", "C", "D", "E"};
+
+typedef struct BenchTimes
+{
+	double Mean;
+	double P50;
+	double P95;
+	double Max;
+} BenchTimes;
+
+typedef struct BenchRun
+{
+	int FramesCount;
+	double Seconds;
+	size_t PoolBytesPeak;
+	size_t TargetBytes;
+	int TimesCount;
+	BenchTimes Cpu[VIEW_VIEWPORT_MAX];
+	BenchTimes Gpu[VIEW_VIEWPORT_MAX];
+} BenchRun;
+
+static double Bench_Now(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return Time.tv_sec + Time.tv_nsec / 1e9;
+}
+
+static int Bench_CompareDouble(const void* A, const void* B)
+{
+	double X = *(const double*) A;
+	double Y = *(const double*) B;
+	
+	return (X > Y) - (X < Y);
+}
+
+// Sorts Values.
+
+static void Bench_Summarize(double* Values, int Count, BenchTimes* Times)
+{
+	double Sum = 0.0;
+	
+	qsort(Values, Count, sizeof(double), Bench_CompareDouble);
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		Sum += Values[Index];
+	}
+	
+	Times->Mean = Sum / Count;
+	Times->P50 = Values[(Count - 1) / 2];
+	Times->P95 = Values[(int) ceil(Count * 0.95) - 1];
+	Times->Max = Values[Count - 1];
+}
+
+// Same as the default views of RenderingEngine_Initialize().
+
+static void Bench_RestoreCamera(CameraControl* Camera, ViewName Name)
+{
+	switch (Name)
+	{
+		case VIEW_PERSPECTIVE: Camera->RestoreToPerspectiveView(Camera); break;
+		case VIEW_FRONT: Camera->RestoreToFrontView(Camera); break;
+		case VIEW_BACK: Camera->RestoreToBackView(Camera); break;
+		case VIEW_TOP: Camera->RestoreToTopView(Camera); break;
+		case VIEW_BOTTOM: Camera->RestoreToBottomView(Camera); break;
+		case VIEW_LEFT: Camera->RestoreToLeftView(Camera); break;
+		case VIEW_RIGHT: Camera->RestoreToRightView(Camera); break;
+		case VIEW_MAX: break;
+	}
+	
+	for (int Step = 0; Step < 1000 && Camera->Animation == CAMERA_CONTROL_ANIMATION_ACTIVE; Step++)
+	{
+		Camera->Update(Camera, 1.0f);
+	}
+}
+
+static void Bench_StartPath(CameraControl* Camera, BenchPath Path)
+{
+	if (Path == BENCH_PATH_ORBIT)
+	{
+		Camera->SetMode(Camera, CAMERA_CONTROL_MODE_ROTATING);
+		Camera->StartDragging(Camera, Camera->HalfViewWidth, Camera->HalfViewHeight);
+	}
+	else if (Path == BENCH_PATH_PAN)
+	{
+		Camera->SetMode(Camera, CAMERA_CONTROL_MODE_PANNING);
+		Camera->StartDragging(Camera, 0.0f, 0.0f);
+		Camera->TrackDragging(Camera, Camera->HalfViewWidth * 1.5f, Camera->HalfViewHeight);
+	}
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// T goes from 0 to 1 over the run. The orbit swings the
+// trackball left and right, the pan drags the pointer around a
+// circle and the zoom goes in and back out.
+
+static void Bench_StepPath(CameraControl* Camera, BenchPath Path, float T, float PreviousT)
+{
+	float Angle = 2.0f * (float) M_PI * T;
+	
+	if (Path == BENCH_PATH_ORBIT)
+	{
+		Camera->TrackDragging(Camera, sinf(Angle) * Camera->HalfViewWidth * 0.5f, sinf(2.0f * Angle) * Camera->HalfViewHeight * 0.25f);
+	}
+	else if (Path == BENCH_PATH_PAN)
+	{
+		Camera->TrackDragging(Camera, Camera->HalfViewWidth * (1.0f + 0.5f * cosf(Angle)), Camera->HalfViewHeight * (1.0f + 0.5f * sinf(Angle)));
+	}
+	else if (Path == BENCH_PATH_ZOOM)
+	{
+		Camera->ForwardTo(Camera, BENCH_ZOOM_DISTANCE * (sinf(0.5f * Angle) - sinf(0.5f * 2.0f * (float) M_PI * PreviousT)));
+	}
+}
+
+static void Bench_StopPath(CameraControl* Camera, BenchPath Path)
+{
+	if (Path != BENCH_PATH_ZOOM)
+	{
+		Camera->StopDragging(Camera);
+	}
+}
+
+static void Bench_RenderPerView(HeadlessRenderer* Renderer, GLuint* Queries, double* CpuMs)
+{
+	for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+	{
+		HeadlessView* View = &Renderer->Views[Index];
+		double Start = Bench_Now();
+		
+		glBeginQuery(GL_TIME_ELAPSED, Queries[Index]);
+		RenderingEngine_Render(&Renderer->Engine, View->ViewportID, Renderer->Fbos[Index], View->Width, View->Height);
+		glEndQuery(GL_TIME_ELAPSED);
+		
+		CpuMs[Index] = (Bench_Now() - Start) * 1000.0;
+	}
+	
+	RenderingEngine_EndFrame(&Renderer->Engine);
+}
+
+static void Bench_RenderBatched(HeadlessRenderer* Renderer, GLuint* Queries, double* CpuMs)
+{
+	double Start = Bench_Now();
+	
+	glBeginQuery(GL_TIME_ELAPSED, Queries[0]);
+	HeadlessRenderer_Render(Renderer);
+	glEndQuery(GL_TIME_ELAPSED);
+	
+	CpuMs[0] = (Bench_Now() - Start) * 1000.0;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A camera left without its view size renders through an
+// identity projection and barely moves along the paths, such
+// a run would time something else than the layout.
+
+static int Bench_CheckCameras(HeadlessRenderer* Renderer)
+{
+	for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+	{
+		HeadlessView* View = &Renderer->Views[Index];
+		CameraControl* Camera = &Renderer->Engine.Cameras[View->Name];
+		
+		if (Camera->ViewWidth != View->Width || Camera->ViewHeight != View->Height)
+		{
+			fprintf(stderr, "Bench->Run() : Camera %s is %d x %d in a %d x %d view !\n", BenchViewNames[View->Name], Camera->ViewWidth, Camera->ViewHeight, View->Width, View->Height);
+			return FALSE;
+		}
+	}
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The queries are only read once the run is done, nothing
+// waits on the GPU in between. Times are indexed by timed
+// slot then frame: one slot per view, or a single one for the
+// batched submission.
+
+static int Bench_Run(HeadlessRenderer* Renderer, BenchPath Path, BenchSubmit Submit, int FramesCount, BenchRun* Run)
+{
+	RenderingEngine* Engine = &Renderer->Engine;
+	int Slots = Submit == BENCH_SUBMIT_BATCHED ? 1 : Renderer->ViewsCount;
+	GLuint* Queries = malloc(sizeof(GLuint) * Slots * FramesCount);
+	double* CpuMs = malloc(sizeof(double) * Slots * FramesCount);
+	double* GpuMs = malloc(sizeof(double) * FramesCount);
+	double FrameCpuMs[VIEW_VIEWPORT_MAX];
+	GLuint WarmupQueries[VIEW_VIEWPORT_MAX];
+	
+	if (Queries == NULL || CpuMs == NULL || GpuMs == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+	
+	glGenQueries(Slots * FramesCount, Queries);
+	glGenQueries(Renderer->ViewsCount, WarmupQueries);
+	
+	for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+	{
+		Bench_RestoreCamera(&Engine->Cameras[Renderer->Views[Index].Name], Renderer->Views[Index].Name);
+	}
+	
+	// The warm up frames also give the cameras their view size.
+	
+	for (int Frame = 0; Frame < BENCH_WARMUP_FRAMES; Frame++)
+	{
+		Bench_RenderPerView(Renderer, WarmupQueries, FrameCpuMs);
+	}
+	
+	glFinish();
+	
+	if (Bench_CheckCameras(Renderer) == FALSE)
+	{
+		glDeleteQueries(Slots * FramesCount, Queries);
+		glDeleteQueries(Renderer->ViewsCount, WarmupQueries);
+		free(Queries);
+		free(CpuMs);
+		free(GpuMs);
+		return FALSE;
+	}
+	
+	for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+	{
+		Bench_StartPath(&Engine->Cameras[Renderer->Views[Index].Name], Path);
+	}
+	
+	Run->PoolBytesPeak = 0;
+	
+	double Start = Bench_Now();
+	
+	for (int Frame = 0; Frame < FramesCount; Frame++)
+	{
+		float T = FramesCount > 1 ? (float) Frame / (FramesCount - 1) : 1.0f;
+		float PreviousT = FramesCount > 1 && Frame > 0 ? (float) (Frame - 1) / (FramesCount - 1) : 0.0f;
+		
+		for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+		{
+			Bench_StepPath(&Engine->Cameras[Renderer->Views[Index].Name], Path, T, PreviousT);
+		}
+		
+		GLuint FrameQueries[VIEW_VIEWPORT_MAX];
+		
+		for (int Slot = 0; Slot < Slots; Slot++)
+		{
+			FrameQueries[Slot] = Queries[Slot * FramesCount + Frame];
+		}
+		
+		if (Submit == BENCH_SUBMIT_BATCHED)
+		{
+			Bench_RenderBatched(Renderer, FrameQueries, FrameCpuMs);
+		}
+		else
+		{
+			Bench_RenderPerView(Renderer, FrameQueries, FrameCpuMs);
+		}
+		
+		for (int Slot = 0; Slot < Slots; Slot++)
+		{
+			CpuMs[Slot * FramesCount + Frame] = FrameCpuMs[Slot];
+		}
+		
+		size_t PoolBytes = FramebufferPool_GetBytesUsed(&Engine->TargetPool);
+		
+		Run->PoolBytesPeak = PoolBytes > Run->PoolBytesPeak ? PoolBytes : Run->PoolBytesPeak;
+	}
+	
+	glFinish();
+	
+	Run->Seconds = Bench_Now() - Start;
+	Run->FramesCount = FramesCount;
+	Run->TimesCount = Slots;
+	Run->TargetBytes = 0;
+	
+	for (int Index = 0; Index < Renderer->ViewsCount; Index++)
+	{
+		Bench_StopPath(&Engine->Cameras[Renderer->Views[Index].Name], Path);
+		Run->TargetBytes += (size_t) Renderer->Views[Index].Width * Renderer->Views[Index].Height * 4;
+	}
+	
+	for (int Slot = 0; Slot < Slots; Slot++)
+	{
+		for (int Frame = 0; Frame < FramesCount; Frame++)
+		{
+			GLuint64 Elapsed = 0;
+			
+			glGetQueryObjectui64v(Queries[Slot * FramesCount + Frame], GL_QUERY_RESULT, &Elapsed);
+			GpuMs[Frame] = Elapsed / 1e6;
+		}
+		
+		Bench_Summarize(CpuMs + Slot * FramesCount, FramesCount, &Run->Cpu[Slot]);
+		Bench_Summarize(GpuMs, FramesCount, &Run->Gpu[Slot]);
+	}
+	
+	glDeleteQueries(Slots * FramesCount, Queries);
+	glDeleteQueries(Renderer->ViewsCount, WarmupQueries);
+	free(Queries);
+	free(CpuMs);
+	free(GpuMs);
+	
+	return TRUE;
+}
+
+static void Bench_WriteString(FILE* File, const char* String)
+{
+	fputc('"', File);
+	
+	for (; *String != '\0'; String++)
+	{
+		if (*String == '"' || *String == '\\')
+		{
+			fputc('\\', File);
+		}
+		
+		if ((unsigned char) *String >= 0x20)
+		{
+			fputc(*String, File);
+		}
+	}
+	
+	fputc('"', File);
+}
+
+static void Bench_WriteTimes(FILE* File, const char* Name, BenchTimes* Times)
+{
+	fprintf(File, "\"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"max\": %.4f}", Name, Times->Mean, Times->P50, Times->P95, Times->Max);
+}
+
+static void Bench_WriteRun(FILE* File, HeadlessRenderer* Renderer, const char* Mode, BenchPath Path, BenchSubmit Submit, BenchRun* Run, int IsFirst)
+{
+	fprintf(File, "%s\n    {\"mode\": \"%s\", \"path\": \"%s\", \"submission\": \"%s\", ", IsFirst ? "" : ",", Mode, BenchPathNames[Path], Submit == BENCH_SUBMIT_BATCHED ? "batched" : "per-view");
+	fprintf(File, "\"width\": %d, \"height\": %d, \"frames\": %d, \"seconds\": %.4f, \"fps\": %.2f, ", Renderer->Width, Renderer->Height, Run->FramesCount, Run->Seconds, Run->FramesCount / Run->Seconds);
+	fprintf(File, "\"fbo_pool_bytes_peak\": %zu, \"fbo_target_bytes\": %zu,\n     \"viewports\": [", Run->PoolBytesPeak, Run->TargetBytes);
+	
+	for (int Slot = 0; Slot < Run->TimesCount; Slot++)
+	{
+		fprintf(File, "%s\n      {", Slot == 0 ? "" : ",");
+		
+		if (Submit == BENCH_SUBMIT_BATCHED)
+		{
+			fprintf(File, "\"viewport\": \"all\", \"view\": \"all\", ");
+		}
+		else
+		{
+			fprintf(File, "\"viewport\": \"%s\", \"view\": \"%s\", ", BenchViewportNames[Renderer->Views[Slot].ViewportID], BenchViewNames[Renderer->Views[Slot].Name]);
+		}
+		
+		Bench_WriteTimes(File, "cpu_ms", &Run->Cpu[Slot]);
+		fprintf(File, ", ");
+		Bench_WriteTimes(File, "gpu_ms", &Run->Gpu[Slot]);
+		fprintf(File, "}");
+	}
+	
+	fprintf(File, "]}");
+}
+
+static int Bench_ParseResolutions(const char* List, int* Widths, int* Heights)
+{
+	int Count = 0;
+	const char* Cursor = List;
+	
+	while (Count < BENCH_RESOLUTIONS_MAX && sscanf(Cursor, "%dx%d", &Widths[Count], &Heights[Count]) == 2 && Widths[Count] > 1 && Heights[Count] > 1)
+	{
+		Count++;
+		Cursor = strchr(Cursor, ',');
+		
+		if (Cursor == NULL)
+		{
+			break;
+		}
+		
+		Cursor++;
+	}
+	
+	return Count;
+}
+
+int main(int argc, char** argv)
+{
+	const char* Path = "Benchmarks/bench-render.json";
+	const char* Resolutions = "640x360,1280x720";
+	int FramesCount = BENCH_FRAMES;
+	int Widths[BENCH_RESOLUTIONS_MAX];
+	int Heights[BENCH_RESOLUTIONS_MAX];
+	int Option;
+	
+	while ((Option = getopt(argc, argv, "o:f:r:")) != -1)
+	{
+		switch (Option)
+		{
+			case 'o': Path = optarg; break;
+			case 'f': FramesCount = atoi(optarg); break;
+			case 'r': Resolutions = optarg; break;
+			
+			default:
+				fprintf(stderr, "Usage : %s [-o PATH] [-f FRAMES] [-r WxH,WxH...]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	
+	int ResolutionsCount = Bench_ParseResolutions(Resolutions, Widths, Heights);
+	
+	if (ResolutionsCount == 0 || FramesCount < 1)
+	{
+		fprintf(stderr, "%s : bad resolutions or frames count\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	
+	HeadlessRenderer Renderer;
+	HeadlessView Views[VIEW_VIEWPORT_MAX];
+	
+	HeadlessRenderer_Init(&Renderer);
+	HeadlessRenderer_SetQuadLayout(Views, Widths[0], Heights[0]);
+	
+	if (HeadlessRenderer_Initialize(&Renderer, Widths[0], Heights[0], 4, Views) == FALSE || HeadlessRenderer_Settle(&Renderer, 60.0) == FALSE)
+	{
+		HeadlessRenderer_Wipeout(&Renderer);
+		return EXIT_FAILURE;
+	}
+	
+	FILE* File = fopen(Path, "w");
+	
+	if (File == NULL)
+	{
+		fprintf(stderr, "%s : Could not open %s\n", argv[0], Path);
+		HeadlessRenderer_Wipeout(&Renderer);
+		return EXIT_FAILURE;
+	}
+	
+	fprintf(File, "{\n  \"renderer\": ");
+	Bench_WriteString(File, (const char*) glGetString(GL_RENDERER));
+	fprintf(File, ",\n  \"gl_version\": ");
+	Bench_WriteString(File, (const char*) glGetString(GL_VERSION));
+	fprintf(File, ",\n  \"mat44f_backend\": \"%s\",\n  \"single_pass\": %s,\n  \"runs\": [", Mat44fBackend_GetName(), Renderer.Engine.SinglePass ? "true" : "false");
+	
+	printf("%s, %d frames per run\n", (const char*) glGetString(GL_RENDERER), FramesCount);
+	
+	int IsFirst = TRUE;
+	
+	for (int Resolution = 0; Resolution < ResolutionsCount; Resolution++)
+	{
+		// Every view alone in the maximized viewport, then the 4 views.
+		
+		for (int Layout = 0; Layout <= VIEW_MAX; Layout++)
+		{
+			int IsMulti = Layout == VIEW_MAX;
+			
+			if (IsMulti)
+			{
+				HeadlessRenderer_SetQuadLayout(Views, Widths[Resolution], Heights[Resolution]);
+			}
+			else
+			{
+				HeadlessRenderer_SetSingleLayout(Views, (ViewName) Layout, Widths[Resolution], Heights[Resolution]);
+			}
+			
+			HeadlessRenderer_SetLayout(&Renderer, Widths[Resolution], Heights[Resolution], IsMulti ? 4 : 1, Views);
+			
+			for (BenchPath Path = 0; Path < BENCH_PATH_MAX; Path++)
+			{
+				for (BenchSubmit Submit = BENCH_SUBMIT_PER_VIEW; Submit <= (IsMulti ? BENCH_SUBMIT_BATCHED : BENCH_SUBMIT_PER_VIEW); Submit++)
+				{
+					BenchRun Run;
+					const char* Mode = IsMulti ? "multi" : BenchViewNames[Layout];
+					
+					if (Bench_Run(&Renderer, Path, Submit, FramesCount, &Run) == FALSE)
+					{
+						fclose(File);
+						HeadlessRenderer_Wipeout(&Renderer);
+						return EXIT_FAILURE;
+					}
+					
+					Bench_WriteRun(File, &Renderer, IsMulti ? "multi" : "single", Path, Submit, &Run, IsFirst);
+					IsFirst = FALSE;
+					
+					printf("%4d x %-4d %-11s %-5s %-8s %8.1f fps\n", Widths[Resolution], Heights[Resolution], Mode, BenchPathNames[Path], Submit == BENCH_SUBMIT_BATCHED ? "batched" : "per-view", Run.FramesCount / Run.Seconds);
+				}
+			}
+		}
+	}
+	
+	fprintf(File, "\n  ]\n}\n");
+	fclose(File);
+	
+	printf("Results written to %s\n", Path);
+	
+	HeadlessRenderer_Wipeout(&Renderer);
+	
+	return EXIT_SUCCESS;
+}
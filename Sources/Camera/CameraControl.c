@@ -40,6 +40,7 @@
 #include <math.h>
 
 #include "CameraControl.h"
+#include "Trace.h"
 
 static void CameraControl_ComputeVectorProjection(CameraControl* This, float x, float y, Vec3f* Vector)
 {
@@ -416,6 +417,8 @@ void CameraControl_RestoreToLeftView(CameraControl* This)
 
 void CameraControl_Update(CameraControl* This, float FrameTime)
 {
+	TRACE_SCOPE("CameraControl_Update");
+	
 	if (This->Animation == CAMERA_CONTROL_ANIMATION_ACTIVE)
 	{
 		if (This->IsMoving == TRUE)
@@ -571,10 +574,19 @@ void CameraControl_StopDragging(CameraControl* This)
 	This->Mode = CAMERA_CONTROL_MODE_INVALID;
 }
 
+// The view is a rigid transform, its inverse is the transposed
+// rotation of the orientation with the position as translation.
+
 void CameraControl_ComputeMatrices(CameraControl* This)
 {
 	CameraControl_ComputeStuff(&This->Target, This->Distance, &This->Orientation, &This->ViewMatrix, &This->Position);
-	Mat44f_Inverse(&This->ViewMatrix, &This->InvViewMatrix);
+	
+	Quat_ToRotationMatrix(&This->Orientation, &This->InvViewMatrix);
+	Mat44f_Transpose(&This->InvViewMatrix);
+	
+	This->InvViewMatrix.e14 = This->Position.X;
+	This->InvViewMatrix.e24 = This->Position.Y;
+	This->InvViewMatrix.e34 = This->Position.Z;
 }
 
 void CameraControl_Clone(CameraControl* This, CameraControl* Source, int Width, int Height)
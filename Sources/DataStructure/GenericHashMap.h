@@ -0,0 +1,377 @@
+/*
+ * GenericHashMap.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef GENERIC_HASH_MAP_H
+#define GENERIC_HASH_MAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FALSE
+	#define FALSE 0
+#endif
+
+#ifndef TRUE
+	#define TRUE 1
+#endif
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A typed hash map generated by macros, the same Robin Hood
+// open addressing as IntegerHashTable but for any key and any
+// value, stored by value in one contiguous slot array. A
+// header declares the type with
+//
+//     GENERIC_HASH_MAP_DECLARE(MeshMap, GLuint, Mesh)
+//
+// and one translation unit generates the functions with
+//
+//     GENERIC_HASH_MAP_DEFINE(MeshMap, GLuint, Mesh, GenericHashMap_HashUInt32, GENERIC_HASH_MAP_EQUALS)
+//
+// The hash function takes a key and returns an uint32_t, the
+// equality test takes two keys, function or macro alike. The
+// pointers returned by Lookup() and Insert() are only valid
+// until the next Insert() or Remove(). A key pointing to
+// memory, a string say, must outlive its entry.
+
+#define GENERIC_HASH_MAP_EMPTY 0
+#define GENERIC_HASH_MAP_MIN_SLOTS 16
+
+#define GENERIC_HASH_MAP_EQUALS(A, B) ((A) == (B))
+#define GENERIC_HASH_MAP_EQUALS_STRING(A, B) (strcmp((A), (B)) == 0)
+
+static inline uint32_t GenericHashMap_HashUInt32(uint32_t Key)
+{
+	Key ^= Key >> 16;
+	Key *= 0x7feb352du;
+	Key ^= Key >> 15;
+	Key *= 0x846ca68bu;
+	Key ^= Key >> 16;
+	
+	return Key;
+}
+
+static inline uint32_t GenericHashMap_HashUInt64(uint64_t Key)
+{
+	Key ^= Key >> 33;
+	Key *= 0xff51afd7ed558ccdull;
+	Key ^= Key >> 33;
+	Key *= 0xc4ceb9fe1a85ec53ull;
+	Key ^= Key >> 33;
+	
+	return (uint32_t) Key;
+}
+
+static inline uint32_t GenericHashMap_HashPointer(const void* Key)
+{
+	return GenericHashMap_HashUInt64((uint64_t) (uintptr_t) Key);
+}
+
+static inline uint32_t GenericHashMap_HashString(const char* Key)
+{
+	uint32_t HashValue = 2166136261u;
+	
+	while (*Key != 0)
+	{
+		HashValue ^= (unsigned char) *Key++;
+		HashValue *= 16777619u;
+	}
+	
+	return HashValue;
+}
+
+#define GENERIC_HASH_MAP_DECLARE(Name, KeyType, ValueType) \
+	\
+	typedef struct Name##Slot \
+	{ \
+		uint32_t Hash; \
+		KeyType Key; \
+		ValueType Value; \
+		\
+	} Name##Slot; \
+	\
+	typedef struct Name \
+	{ \
+		Name##Slot* Slots; \
+		size_t SlotsMax; \
+		size_t Count; \
+		\
+	} Name; \
+	\
+	typedef struct Name##Iterator \
+	{ \
+		Name* Map; \
+		size_t Index; \
+		KeyType* Key; \
+		ValueType* Value; \
+		\
+	} Name##Iterator; \
+	\
+	uint32_t Name##_Hash(KeyType); \
+	ValueType* Name##_LookupHashed(Name*, KeyType, uint32_t); \
+	ValueType* Name##_Lookup(Name*, KeyType); \
+	ValueType* Name##_Insert(Name*, KeyType, ValueType); \
+	int Name##_Remove(Name*, KeyType); \
+	size_t Name##_Count(Name*); \
+	void Name##_Clear(Name*); \
+	void Name##_Wipeout(Name*); \
+	void Name##_Init(Name*, size_t); \
+	void Name##Iterator_Init(Name##Iterator*, Name*); \
+	int Name##Iterator_Next(Name##Iterator*);
+
+#define GENERIC_HASH_MAP_DEFINE(Name, KeyType, ValueType, HashFunction, EqualsFunction) \
+	\
+	uint32_t Name##_Hash(KeyType Key) \
+	{ \
+		uint32_t HashValue = HashFunction(Key); \
+		\
+		return HashValue != GENERIC_HASH_MAP_EMPTY ? HashValue : 1; \
+	} \
+	\
+	static size_t Name##_ProbeDistance(Name* This, size_t Index) \
+	{ \
+		return (Index - (This->Slots[Index].Hash & (This->SlotsMax - 1))) & (This->SlotsMax - 1); \
+	} \
+	\
+	static size_t Name##_PlaceSlot(Name* This, Name##Slot Slot) \
+	{ \
+		size_t Mask = This->SlotsMax - 1; \
+		size_t Index = Slot.Hash & Mask; \
+		size_t Distance = 0; \
+		size_t Placed = (size_t) -1; \
+		\
+		while (TRUE) \
+		{ \
+			if (This->Slots[Index].Hash == GENERIC_HASH_MAP_EMPTY) \
+			{ \
+				This->Slots[Index] = Slot; \
+				return Placed != (size_t) -1 ? Placed : Index; \
+			} \
+			\
+			size_t SlotDistance = Name##_ProbeDistance(This, Index); \
+			\
+			if (SlotDistance < Distance) \
+			{ \
+				Name##Slot Swap = This->Slots[Index]; \
+				This->Slots[Index] = Slot; \
+				Slot = Swap; \
+				Distance = SlotDistance; \
+				\
+				if (Placed == (size_t) -1) \
+				{ \
+					Placed = Index; \
+				} \
+			} \
+			\
+			Index = (Index + 1) & Mask; \
+			Distance++; \
+		} \
+	} \
+	\
+	static void Name##_Resize(Name* This, size_t SlotsMax) \
+	{ \
+		Name##Slot* Slots = This->Slots; \
+		size_t PreviousMax = This->SlotsMax; \
+		\
+		This->Slots = calloc(SlotsMax, sizeof(Name##Slot)); \
+		\
+		if (This->Slots == NULL) \
+		{ \
+			exit(EXIT_FAILURE); \
+		} \
+		\
+		This->SlotsMax = SlotsMax; \
+		\
+		for (size_t Index = 0; Index < PreviousMax; Index++) \
+		{ \
+			if (Slots[Index].Hash != GENERIC_HASH_MAP_EMPTY) \
+			{ \
+				Name##_PlaceSlot(This, Slots[Index]); \
+			} \
+		} \
+		\
+		free(Slots); \
+	} \
+	\
+	static size_t Name##_Find(Name* This, KeyType Key, uint32_t Hash) \
+	{ \
+		if (This->SlotsMax == 0) \
+		{ \
+			return (size_t) -1; \
+		} \
+		\
+		size_t Mask = This->SlotsMax - 1; \
+		size_t Index = Hash & Mask; \
+		\
+		for (size_t Distance = 0; This->Slots[Index].Hash != GENERIC_HASH_MAP_EMPTY; Distance++) \
+		{ \
+			if (Name##_ProbeDistance(This, Index) < Distance) \
+			{ \
+				break; \
+			} \
+			\
+			if (This->Slots[Index].Hash == Hash && EqualsFunction(This->Slots[Index].Key, Key)) \
+			{ \
+				return Index; \
+			} \
+			\
+			Index = (Index + 1) & Mask; \
+		} \
+		\
+		return (size_t) -1; \
+	} \
+	\
+	ValueType* Name##_LookupHashed(Name* This, KeyType Key, uint32_t Hash) \
+	{ \
+		size_t Index = Name##_Find(This, Key, Hash); \
+		\
+		return Index != (size_t) -1 ? &This->Slots[Index].Value : NULL; \
+	} \
+	\
+	ValueType* Name##_Lookup(Name* This, KeyType Key) \
+	{ \
+		return Name##_LookupHashed(This, Key, Name##_Hash(Key)); \
+	} \
+	\
+	ValueType* Name##_Insert(Name* This, KeyType Key, ValueType Value) \
+	{ \
+		uint32_t Hash = Name##_Hash(Key); \
+		size_t Index = Name##_Find(This, Key, Hash); \
+		\
+		if (Index != (size_t) -1) \
+		{ \
+			This->Slots[Index].Value = Value; \
+			return &This->Slots[Index].Value; \
+		} \
+		\
+		if ((This->Count + 1) * 4 > This->SlotsMax * 3) \
+		{ \
+			Name##_Resize(This, This->SlotsMax > 0 ? This->SlotsMax * 2 : GENERIC_HASH_MAP_MIN_SLOTS); \
+		} \
+		\
+		Name##Slot Slot; \
+		Slot.Hash = Hash; \
+		Slot.Key = Key; \
+		Slot.Value = Value; \
+		\
+		This->Count++; \
+		\
+		return &This->Slots[Name##_PlaceSlot(This, Slot)].Value; \
+	} \
+	\
+	int Name##_Remove(Name* This, KeyType Key) \
+	{ \
+		size_t Index = Name##_Find(This, Key, Name##_Hash(Key)); \
+		\
+		if (Index == (size_t) -1) \
+		{ \
+			return FALSE; \
+		} \
+		\
+		size_t Mask = This->SlotsMax - 1; \
+		size_t Next = (Index + 1) & Mask; \
+		\
+		while (This->Slots[Next].Hash != GENERIC_HASH_MAP_EMPTY && Name##_ProbeDistance(This, Next) > 0) \
+		{ \
+			This->Slots[Index] = This->Slots[Next]; \
+			Index = Next; \
+			Next = (Next + 1) & Mask; \
+		} \
+		\
+		This->Slots[Index].Hash = GENERIC_HASH_MAP_EMPTY; \
+		This->Count--; \
+		\
+		return TRUE; \
+	} \
+	\
+	size_t Name##_Count(Name* This) \
+	{ \
+		return This->Count; \
+	} \
+	\
+	void Name##_Clear(Name* This) \
+	{ \
+		if (This->Slots != NULL) \
+		{ \
+			memset(This->Slots, 0, sizeof(Name##Slot) * This->SlotsMax); \
+		} \
+		\
+		This->Count = 0; \
+	} \
+	\
+	void Name##_Wipeout(Name* This) \
+	{ \
+		free(This->Slots); \
+		This->Slots = NULL; \
+		This->SlotsMax = 0; \
+		This->Count = 0; \
+	} \
+	\
+	void Name##_Init(Name* This, size_t Expected) \
+	{ \
+		This->Slots = NULL; \
+		This->SlotsMax = 0; \
+		This->Count = 0; \
+		\
+		if (Expected > 0) \
+		{ \
+			size_t SlotsMax = GENERIC_HASH_MAP_MIN_SLOTS; \
+			\
+			while (SlotsMax * 3 < Expected * 4) \
+			{ \
+				SlotsMax *= 2; \
+			} \
+			\
+			Name##_Resize(This, SlotsMax); \
+		} \
+	} \
+	\
+	void Name##Iterator_Init(Name##Iterator* This, Name* Map) \
+	{ \
+		This->Map = Map; \
+		This->Index = 0; \
+		This->Key = NULL; \
+		This->Value = NULL; \
+	} \
+	\
+	int Name##Iterator_Next(Name##Iterator* This) \
+	{ \
+		while (This->Index < This->Map->SlotsMax) \
+		{ \
+			Name##Slot* Slot = &This->Map->Slots[This->Index++]; \
+			\
+			if (Slot->Hash != GENERIC_HASH_MAP_EMPTY) \
+			{ \
+				This->Key = &Slot->Key; \
+				This->Value = &Slot->Value; \
+				return TRUE; \
+			} \
+		} \
+		\
+		This->Key = NULL; \
+		This->Value = NULL; \
+		\
+		return FALSE; \
+	}
+
+#endif
@@ -26,24 +26,165 @@
 
 #include "IntegerHashTable.h"
 
-size_t IntegerHashTable_HashFunction(IntegerHashTable* This, char* Key)
+#define INTEGER_HASH_TABLE_MIN_SLOTS 16
+#define INTEGER_HASH_TABLE_MIN_KEYS 256
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// FNV-1a, never 0 as a 0 hash marks an empty slot.
+
+uint32_t IntegerHashTable_Hash(const char* Key)
+{
+	uint32_t HashValue = 2166136261u;
+	
+	while (*Key != 0)
+	{
+		HashValue ^= (unsigned char) *Key++;
+		HashValue *= 16777619u;
+	}
+	
+	return HashValue != INTEGER_HASH_TABLE_EMPTY ? HashValue : 1;
+}
+
+static size_t IntegerHashTable_ProbeDistance(IntegerHashTable* This, size_t Index)
+{
+	return (Index - (This->Table[Index].Hash & (This->TableMax - 1))) & (This->TableMax - 1);
+}
+
+static uint32_t IntegerHashTable_InternKey(IntegerHashTable* This, const char* Key)
 {
-	size_t Len = strlen(Key);
-	size_t HashValue = 0;
+	size_t Length = strlen(Key) + 1;
 	
-	for(size_t CharID = 0; CharID < Len; CharID++)
+	if (This->KeysLength + Length > This->KeysMax)
 	{
-		HashValue = ((HashValue << 6) ^ (HashValue >> 2) ^ Key[CharID]) % This->TableMax;
+		size_t KeysMax = This->KeysMax > 0 ? This->KeysMax : INTEGER_HASH_TABLE_MIN_KEYS;
+		
+		while (This->KeysLength + Length > KeysMax)
+		{
+			KeysMax *= 2;
+		}
+		
+		This->Keys = realloc(This->Keys, KeysMax);
+		
+		if (This->Keys == NULL)
+		{
+			exit(EXIT_FAILURE);
+		}
+		
+		This->KeysMax = KeysMax;
 	}
 	
-	return HashValue;
+	uint32_t KeyOffset = (uint32_t) This->KeysLength;
+	
+	memcpy(This->Keys + This->KeysLength, Key, Length);
+	This->KeysLength += Length;
+	
+	return KeyOffset;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Robin Hood: a slot closer to its home than the one being
+// placed gives its spot away and gets placed further. Returns
+// where the given slot ended up.
+
+static size_t IntegerHashTable_PlaceSlot(IntegerHashTable* This, IntegerHashTableSlot Slot)
+{
+	size_t Mask = This->TableMax - 1;
+	size_t Index = Slot.Hash & Mask;
+	size_t Distance = 0;
+	size_t Placed = INTEGER_HASH_TABLE_NO_BUCKET;
+	
+	while (TRUE)
+	{
+		if (This->Table[Index].Hash == INTEGER_HASH_TABLE_EMPTY)
+		{
+			This->Table[Index] = Slot;
+			return Placed != INTEGER_HASH_TABLE_NO_BUCKET ? Placed : Index;
+		}
+		
+		size_t SlotDistance = IntegerHashTable_ProbeDistance(This, Index);
+		
+		if (SlotDistance < Distance)
+		{
+			IntegerHashTableSlot Swap = This->Table[Index];
+			This->Table[Index] = Slot;
+			Slot = Swap;
+			Distance = SlotDistance;
+			
+			if (Placed == INTEGER_HASH_TABLE_NO_BUCKET)
+			{
+				Placed = Index;
+			}
+		}
+		
+		Index = (Index + 1) & Mask;
+		Distance++;
+	}
+}
+
+static void IntegerHashTable_Resize(IntegerHashTable* This, size_t TableMax)
+{
+	IntegerHashTableSlot* Table = This->Table;
+	size_t PreviousMax = This->TableMax;
+	
+	This->Table = calloc(TableMax, sizeof(IntegerHashTableSlot));
+	
+	if (This->Table == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+	
+	This->TableMax = TableMax;
+	This->CurrentBucket = INTEGER_HASH_TABLE_NO_BUCKET;
+	
+	for (size_t Index = 0; Index < PreviousMax; Index++)
+	{
+		if (Table[Index].Hash != INTEGER_HASH_TABLE_EMPTY)
+		{
+			IntegerHashTable_PlaceSlot(This, Table[Index]);
+		}
+	}
+	
+	free(Table);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Removed keys stay in the arena until they make half of it.
+
+static void IntegerHashTable_CompactKeys(IntegerHashTable* This)
+{
+	char* Keys = malloc(This->KeysMax);
+	size_t KeysLength = 0;
+	
+	if (Keys == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+	
+	for (size_t Index = 0; Index < This->TableMax; Index++)
+	{
+		IntegerHashTableSlot* Slot = &This->Table[Index];
+		
+		if (Slot->Hash != INTEGER_HASH_TABLE_EMPTY)
+		{
+			size_t Length = strlen(This->Keys + Slot->KeyOffset) + 1;
+			
+			memcpy(Keys + KeysLength, This->Keys + Slot->KeyOffset, Length);
+			Slot->KeyOffset = (uint32_t) KeysLength;
+			KeysLength += Length;
+		}
+	}
+	
+	free(This->Keys);
+	This->Keys = Keys;
+	This->KeysLength = KeysLength;
+	This->KeysGarbage = 0;
 }
 
 char* IntegerHashTable_GetBucketKey(IntegerHashTable* This)
 {
-	if (This->CurrentBucket != NULL)
+	if (This->CurrentBucket != INTEGER_HASH_TABLE_NO_BUCKET)
 	{
-		return This->CurrentBucket->Key;
+		return This->Keys + This->Table[This->CurrentBucket].KeyOffset;
 	}
 	
 	return NULL;
@@ -51,9 +192,9 @@ char* IntegerHashTable_GetBucketKey(IntegerHashTable* This)
 
 int IntegerHashTable_GetBucketValue(IntegerHashTable* This)
 {
-	if (This->CurrentBucket != NULL)
+	if (This->CurrentBucket != INTEGER_HASH_TABLE_NO_BUCKET)
 	{
-		return This->CurrentBucket->Value;
+		return This->Table[This->CurrentBucket].Value;
 	}
 	
 	return 0;
@@ -61,209 +202,199 @@ int IntegerHashTable_GetBucketValue(IntegerHashTable* This)
 
 void IntegerHashTable_UpdateBucket(IntegerHashTable* This, int Value)
 {
-	if (This->CurrentBucket != NULL)
+	if (This->CurrentBucket != INTEGER_HASH_TABLE_NO_BUCKET)
 	{
-		This->CurrentBucket->Value = Value;
+		This->Table[This->CurrentBucket].Value = Value;
 	}
 }
 
-int IntegerHashTable_LookupBucket(IntegerHashTable* This, char* Key)
+int IntegerHashTable_LookupBucketHashed(IntegerHashTable* This, char* Key, uint32_t Hash)
 {
-	size_t Index = IntegerHashTable_HashFunction(This, Key);
-	IntegerHashTableBucket* Cursor = This->Table[Index];
+	This->CurrentBucket = INTEGER_HASH_TABLE_NO_BUCKET;
 	
-	while (Cursor != NULL)
+	if (This->TableMax == 0)
 	{
-		if (strcmp(Key, Cursor->Key) == 0)
+		return FALSE;
+	}
+	
+	size_t Mask = This->TableMax - 1;
+	size_t Index = Hash & Mask;
+	
+	for (size_t Distance = 0; This->Table[Index].Hash != INTEGER_HASH_TABLE_EMPTY; Distance++)
+	{
+		// Past its own distance, the key would have taken this slot.
+		
+		if (IntegerHashTable_ProbeDistance(This, Index) < Distance)
+		{
+			return FALSE;
+		}
+		
+		if (This->Table[Index].Hash == Hash && strcmp(Key, This->Keys + This->Table[Index].KeyOffset) == 0)
 		{
-			This->CurrentBucket = Cursor;
+			This->CurrentBucket = Index;
 			return TRUE;
 		}
 		
-		Cursor = Cursor->NextBucket;
+		Index = (Index + 1) & Mask;
 	}
-
+	
 	return FALSE;
 }
 
+int IntegerHashTable_LookupBucket(IntegerHashTable* This, char* Key)
+{
+	return IntegerHashTable_LookupBucketHashed(This, Key, IntegerHashTable_Hash(Key));
+}
+
 void IntegerHashTable_AddBucket(IntegerHashTable* This, char* Key, int Value)
 {
-	if (IntegerHashTable_LookupBucket(This, Key) == FALSE)
+	uint32_t Hash = IntegerHashTable_Hash(Key);
+	
+	if (IntegerHashTable_LookupBucketHashed(This, Key, Hash) == TRUE)
 	{
-		IntegerHashTableBucket* NewBucket = calloc(1, sizeof(IntegerHashTableBucket));
-		NewBucket->Key = strdup(Key);
-		NewBucket->Value = Value;
-		size_t Index = IntegerHashTable_HashFunction(This, Key);
-		IntegerHashTableBucket* Cursor = This->Table[Index];
-		NewBucket->NextBucket = Cursor;
-		This->Table[Index] = NewBucket;
-		This->CurrentBucket = NewBucket;
-		This->BucketsMax++;
+		IntegerHashTable_UpdateBucket(This, Value);
+		return;
 	}
-	else
+	
+	if ((This->BucketsMax + 1) * 4 > This->TableMax * 3)
 	{
-		IntegerHashTable_UpdateBucket(This, Value);
+		IntegerHashTable_Resize(This, This->TableMax > 0 ? This->TableMax * 2 : INTEGER_HASH_TABLE_MIN_SLOTS);
 	}
 	
+	IntegerHashTableSlot Slot = {Hash, IntegerHashTable_InternKey(This, Key), Value};
+	
+	This->CurrentBucket = IntegerHashTable_PlaceSlot(This, Slot);
+	This->BucketsMax++;
 }
 
 int IntegerHashTable_RemoveBucket(IntegerHashTable* This, char* Key)
 {
-	This->CurrentBucket = NULL;
-	size_t Index = IntegerHashTable_HashFunction(This, Key);
-	IntegerHashTableBucket* Cursor = This->Table[Index];
-	IntegerHashTableBucket* Previous = NULL; 
-	IntegerHashTableBucket* Head = NULL; 
-	
-	while (Cursor != NULL && strcmp(Key, Cursor->Key) != 0)
-	{
-		Previous = Cursor;
-		Cursor = Cursor->NextBucket;
-	}
-	
-	if (Cursor == NULL)
+	if (IntegerHashTable_LookupBucket(This, Key) == FALSE)
 	{
 		return FALSE;
 	}
 	
-	if (Previous == NULL)
+	size_t Mask = This->TableMax - 1;
+	size_t Index = This->CurrentBucket;
+	size_t Next = (Index + 1) & Mask;
+	
+	This->KeysGarbage += strlen(This->Keys + This->Table[Index].KeyOffset) + 1;
+	
+	// Backward shift, the followers move one slot closer to home.
+	
+	while (This->Table[Next].Hash != INTEGER_HASH_TABLE_EMPTY && IntegerHashTable_ProbeDistance(This, Next) > 0)
 	{
-
-		Head = This->Table[Index];
-		This->Table[Index] = Cursor->NextBucket;
-		free(Head->Key);
-		free(Head);
-		This->BucketsMax--;
+		This->Table[Index] = This->Table[Next];
+		Index = Next;
+		Next = (Next + 1) & Mask;
 	}
-	else
+	
+	This->Table[Index].Hash = INTEGER_HASH_TABLE_EMPTY;
+	This->CurrentBucket = INTEGER_HASH_TABLE_NO_BUCKET;
+	This->BucketsMax--;
+	
+	if (This->KeysGarbage > INTEGER_HASH_TABLE_MIN_KEYS && This->KeysGarbage * 2 > This->KeysLength)
 	{
-		Previous->NextBucket = Cursor->NextBucket;
-		free(Cursor->Key);	
-		free(Cursor);
-		This->BucketsMax--;
+		IntegerHashTable_CompactKeys(This);
 	}
 	
 	return TRUE;
 }
 
-void IntegerHashTable_ResetBuckets(IntegerHashTable* This)
+size_t IntegerHashTable_BucketsCount(IntegerHashTable* This)
 {
-	This->CurrentBucket = NULL;
-	This->CurrentIndex = (size_t)-1;
+	return This->BucketsMax;
 }
 
-void* IntegerHashTable_NextBucket(IntegerHashTable* This)
+void IntegerHashTable_RemoveAllBuckets(IntegerHashTable* This)
 {
-	IntegerHashTableBucket* Cursor = NULL;
-	
-	if (This->CurrentBucket == NULL && This->CurrentIndex == (size_t)-1)
-	{
-		This->CurrentIndex = 0;
-		
-		for (size_t Index = This->CurrentIndex; Index < This->TableMax; Index++)
-		{
-			Cursor = This->Table[Index];
-			
-			if (Cursor != NULL)
-			{
-				This->CurrentIndex = Index;
-				This->CurrentBucket = Cursor;
-				
-				return This->CurrentBucket;
-			}
-		}
-		
-	}
-	else
+	if (This->Table != NULL)
 	{
-		if (This->CurrentBucket->NextBucket != NULL)
-		{
-			This->CurrentBucket = This->CurrentBucket->NextBucket;
-			return This->CurrentBucket;
-		}
-		else
-		{
-			This->CurrentIndex++;
-			
-			while (This->CurrentIndex < This->TableMax)
-			{
-				Cursor = This->Table[This->CurrentIndex];
-				
-				if (Cursor != NULL)
-				{
-					This->CurrentBucket = Cursor;
-					return This->CurrentBucket;
-				}
-				
-				This->CurrentIndex++;
-			}
-		}
+		memset(This->Table, 0, sizeof(IntegerHashTableSlot) * This->TableMax);
 	}
 	
-	return NULL;
+	This->CurrentBucket = INTEGER_HASH_TABLE_NO_BUCKET;
+	This->BucketsMax = 0;
+	This->KeysLength = 0;
+	This->KeysGarbage = 0;
 }
 
-size_t IntegerHashTable_BucketsCount(IntegerHashTable* This)
+void IntegerHashTable_Wipeout(IntegerHashTable* This)
 {
-	return This->BucketsMax;
+	free(This->Table);
+	free(This->Keys);
+	
+	This->Table = NULL;
+	This->Keys = NULL;
+	This->TableMax = 0;
+	This->KeysMax = 0;
+	This->KeysLength = 0;
+	This->BucketsMax = 0;
 }
 
-void IntegerHashTable_RemoveAllBuckets(IntegerHashTable* This)
+void IntegerHashTableIterator_Init(IntegerHashTableIterator* This, IntegerHashTable* Table)
 {
-	IntegerHashTableBucket* Cursor = NULL;
-	IntegerHashTableBucket* Temp = NULL;
+	This->Table = Table;
+	This->Index = 0;
+	This->Key = NULL;
+	This->Value = 0;
+}
+
+int IntegerHashTableIterator_Next(IntegerHashTableIterator* This)
+{
+	IntegerHashTable* Table = This->Table;
 	
-	for (size_t Index = 0; Index < This->TableMax; Index ++)
+	while (This->Index < Table->TableMax)
 	{
-		Cursor = This->Table[Index];
+		IntegerHashTableSlot* Slot = &Table->Table[This->Index++];
 		
-		if (Cursor != NULL)
+		if (Slot->Hash != INTEGER_HASH_TABLE_EMPTY)
 		{
-			while (Cursor != NULL)
-			{
-			
-				free(Cursor->Key);	
-				Temp = Cursor;
-				Cursor = Cursor->NextBucket;
-				free(Temp);
-				
-			}
+			This->Key = Table->Keys + Slot->KeyOffset;
+			This->Value = Slot->Value;
+			return TRUE;
 		}
-		
-		This->Table[Index] = NULL;
 	}
+	
+	This->Key = NULL;
+	
+	return FALSE;
 }
 
-void IntegerHashTable_Wipeout(IntegerHashTable* This)
-{
-	IntegerHashTable_RemoveAllBuckets(This);
-	free(This->Table);
-}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// TableMax is the expected number of keys, the slots get
+// rounded up to a power of two above it at 3/4 load.
 
 void IntegerHashTable_Init(IntegerHashTable* This, size_t TableMax)
 {
 	This->GetBucketKey = IntegerHashTable_GetBucketKey;
 	This->GetBucketValue = IntegerHashTable_GetBucketValue;
-    This->UpdateBucket = IntegerHashTable_UpdateBucket;
-    This->LookupBucket = IntegerHashTable_LookupBucket;
-    This->AddBucket = IntegerHashTable_AddBucket;
-    This->RemoveBucket = IntegerHashTable_RemoveBucket;
-	This->ResetBuckets = IntegerHashTable_ResetBuckets;
-	This->NextBucket = IntegerHashTable_NextBucket;
+	This->UpdateBucket = IntegerHashTable_UpdateBucket;
+	This->LookupBucket = IntegerHashTable_LookupBucket;
+	This->LookupBucketHashed = IntegerHashTable_LookupBucketHashed;
+	This->AddBucket = IntegerHashTable_AddBucket;
+	This->RemoveBucket = IntegerHashTable_RemoveBucket;
 	This->BucketsCount = IntegerHashTable_BucketsCount;
 	This->RemoveAllBuckets = IntegerHashTable_RemoveAllBuckets;
 	This->Wipeout = IntegerHashTable_Wipeout;
 	
-	if (TableMax < 10)
+	size_t SlotsMax = INTEGER_HASH_TABLE_MIN_SLOTS;
+	
+	while (SlotsMax * 3 < TableMax * 4)
 	{
-		TableMax = 10;
+		SlotsMax *= 2;
 	}
 	
-	This->TableMax = TableMax;
+	This->TableMax = SlotsMax;
 	This->BucketsMax = 0;
-	This->CurrentIndex = (size_t)-1;
+	This->CurrentBucket = INTEGER_HASH_TABLE_NO_BUCKET;
 	
-	This->Table = calloc(This->TableMax, sizeof(IntegerHashTableBucket*));
+	This->Keys = NULL;
+	This->KeysLength = 0;
+	This->KeysMax = 0;
+	This->KeysGarbage = 0;
+	
+	This->Table = calloc(This->TableMax, sizeof(IntegerHashTableSlot));
 	
 	if (This->Table == NULL)
 	{
@@ -271,4 +402,3 @@ void IntegerHashTable_Init(IntegerHashTable* This, size_t TableMax)
 	}
 	
 }
-
@@ -25,6 +25,7 @@
 #define INTEGER_HASH_TABLE_H
 
 #include <stdlib.h>
+#include <stdint.h>
 
 #ifndef FALSE
 	#define FALSE 0
@@ -34,37 +35,73 @@
 	#define TRUE 1
 #endif
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Open addressing with Robin Hood probing. The slots only hold
+// the hash, the value and the offset of the key, the keys are
+// interned in one contiguous arena. The table doubles past a
+// 3/4 load factor. Removing shifts the following slots back,
+// no tombstone is ever left.
+//
+// LookupBucket() and AddBucket() select a bucket, the Get and
+// Update methods then act on it. GetBucketKey() points into
+// the arena, only valid until the next AddBucket() or
+// RemoveBucket(). A hot path can hash a constant key once
+// with IntegerHashTable_Hash() and use LookupBucketHashed().
+//
+// Iterating goes through an IntegerHashTableIterator of the
+// caller, any number of them may run at once as long as the
+// table is not modified meanwhile.
+
+#define INTEGER_HASH_TABLE_EMPTY 0
+#define INTEGER_HASH_TABLE_NO_BUCKET ((size_t) -1)
+
 typedef struct IntegerHashTable IntegerHashTable;
 
-typedef struct IntegerHashTableBucket
+typedef struct IntegerHashTableSlot
+{
+	uint32_t Hash;
+	uint32_t KeyOffset;
+	int Value;
+	
+} IntegerHashTableSlot;
+
+typedef struct IntegerHashTableIterator
 {
+	IntegerHashTable* Table;
+	size_t Index;
 	char* Key;
 	int Value;
-	struct IntegerHashTableBucket* NextBucket;
 	
-} IntegerHashTableBucket;  
+} IntegerHashTableIterator;
 
 struct IntegerHashTable
 {
 	size_t TableMax;
-	IntegerHashTableBucket** Table;
-	IntegerHashTableBucket* CurrentBucket; 
-	size_t CurrentIndex;
+	IntegerHashTableSlot* Table;
+	size_t CurrentBucket;
 	size_t BucketsMax;
+	
+	char* Keys;
+	size_t KeysLength;
+	size_t KeysMax;
+	size_t KeysGarbage;
+	
 	char* (*GetBucketKey)(IntegerHashTable*);
 	int (*GetBucketValue)(IntegerHashTable*);
 	void (*UpdateBucket)(IntegerHashTable*, int);
 	int (*LookupBucket)(IntegerHashTable*, char*);
+	int (*LookupBucketHashed)(IntegerHashTable*, char*, uint32_t);
 	void (*AddBucket)(IntegerHashTable*, char*, int);
 	int (*RemoveBucket)(IntegerHashTable*, char*);
-	void (*ResetBuckets)(IntegerHashTable*);
-	void* (*NextBucket)(IntegerHashTable*);
 	size_t (*BucketsCount)(IntegerHashTable*);
 	void (*RemoveAllBuckets)(IntegerHashTable*);
 	void (*Wipeout)(IntegerHashTable*);
 };
 
+uint32_t IntegerHashTable_Hash(const char*);
 void IntegerHashTable_Init(IntegerHashTable*, size_t);
 
-#endif
+void IntegerHashTableIterator_Init(IntegerHashTableIterator*, IntegerHashTable*);
+int IntegerHashTableIterator_Next(IntegerHashTableIterator*);
 
+#endif
@@ -0,0 +1,282 @@
+/*
+ * SlotMap.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifndef FALSE
+	#define FALSE 0
+#endif
+
+#ifndef TRUE
+	#define TRUE 1
+#endif
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A typed dense slot map generated by macros. The items live
+// packed in Data[0..Count[, ready for a plain loop, and are
+// reached from outside through a SlotMapHandle which stays
+// valid until its item is removed. Add and Remove are O(1),
+// a removal moves the last item into the hole. The slots of
+// removed items are recycled through a free list, with their
+// generation bumped so a stale handle is rejected. Nothing is
+// allocated per item, the arrays only grow by doubling.
+//
+//     SLOT_MAP_DECLARE(MaterialMap, Material)
+//     SLOT_MAP_DEFINE(MaterialMap, Material)
+//
+// The pointers returned by Get() and Add() are only valid
+// until the next Add() or Remove(), keep the handle instead.
+
+#define SLOT_MAP_FREE_END UINT32_MAX
+#define SLOT_MAP_MIN_ITEMS 8
+
+typedef struct SlotMapHandle
+{
+	uint32_t Index;
+	uint32_t Generation;
+	
+} SlotMapHandle;
+
+typedef struct SlotMapSlot
+{
+	uint32_t DataIndex;
+	uint32_t Generation;
+	uint32_t NextFree;
+	
+} SlotMapSlot;
+
+static const SlotMapHandle SlotMapHandle_Invalid = {SLOT_MAP_FREE_END, 0};
+
+static inline int SlotMapHandle_IsValid(SlotMapHandle Handle)
+{
+	return Handle.Index != SLOT_MAP_FREE_END;
+}
+
+#define SLOT_MAP_DECLARE(Name, Type) \
+	\
+	typedef struct Name \
+	{ \
+		Type* Data; \
+		uint32_t* DataSlots; \
+		uint32_t Count; \
+		uint32_t DataMax; \
+		\
+		SlotMapSlot* Slots; \
+		uint32_t SlotsCount; \
+		uint32_t SlotsMax; \
+		uint32_t FreeSlot; \
+		\
+	} Name; \
+	\
+	SlotMapHandle Name##_Add(Name*, const Type*); \
+	Type* Name##_Get(Name*, SlotMapHandle); \
+	int Name##_Remove(Name*, SlotMapHandle); \
+	SlotMapHandle Name##_GetHandle(Name*, uint32_t); \
+	uint32_t Name##_Count(Name*); \
+	void Name##_Clear(Name*); \
+	void Name##_Wipeout(Name*); \
+	void Name##_Init(Name*, uint32_t);
+
+#define SLOT_MAP_DEFINE(Name, Type) \
+	\
+	static void Name##_GrowData(Name* This) \
+	{ \
+		uint32_t DataMax = This->DataMax > 0 ? This->DataMax * 2 : SLOT_MAP_MIN_ITEMS; \
+		Type* Data = realloc(This->Data, sizeof(Type) * DataMax); \
+		uint32_t* DataSlots = realloc(This->DataSlots, sizeof(uint32_t) * DataMax); \
+		\
+		if (Data == NULL || DataSlots == NULL) \
+		{ \
+			exit(EXIT_FAILURE); \
+		} \
+		\
+		This->Data = Data; \
+		This->DataSlots = DataSlots; \
+		This->DataMax = DataMax; \
+	} \
+	\
+	static uint32_t Name##_TakeSlot(Name* This) \
+	{ \
+		if (This->FreeSlot != SLOT_MAP_FREE_END) \
+		{ \
+			uint32_t Index = This->FreeSlot; \
+			This->FreeSlot = This->Slots[Index].NextFree; \
+			return Index; \
+		} \
+		\
+		if (This->SlotsCount == This->SlotsMax) \
+		{ \
+			uint32_t SlotsMax = This->SlotsMax > 0 ? This->SlotsMax * 2 : SLOT_MAP_MIN_ITEMS; \
+			SlotMapSlot* Slots = realloc(This->Slots, sizeof(SlotMapSlot) * SlotsMax); \
+			\
+			if (Slots == NULL) \
+			{ \
+				exit(EXIT_FAILURE); \
+			} \
+			\
+			This->Slots = Slots; \
+			This->SlotsMax = SlotsMax; \
+		} \
+		\
+		This->Slots[This->SlotsCount].Generation = 0; \
+		\
+		return This->SlotsCount++; \
+	} \
+	\
+	SlotMapHandle Name##_Add(Name* This, const Type* Item) \
+	{ \
+		if (This->Count == This->DataMax) \
+		{ \
+			Name##_GrowData(This); \
+		} \
+		\
+		uint32_t Index = Name##_TakeSlot(This); \
+		SlotMapSlot* Slot = &This->Slots[Index]; \
+		\
+		Slot->DataIndex = This->Count; \
+		Slot->NextFree = SLOT_MAP_FREE_END; \
+		\
+		This->Data[This->Count] = *Item; \
+		This->DataSlots[This->Count] = Index; \
+		This->Count++; \
+		\
+		SlotMapHandle Handle = {Index, Slot->Generation}; \
+		\
+		return Handle; \
+	} \
+	\
+	static SlotMapSlot* Name##_Resolve(Name* This, SlotMapHandle Handle) \
+	{ \
+		if (Handle.Index >= This->SlotsCount) \
+		{ \
+			return NULL; \
+		} \
+		\
+		SlotMapSlot* Slot = &This->Slots[Handle.Index]; \
+		\
+		if (Slot->Generation != Handle.Generation || Slot->DataIndex == SLOT_MAP_FREE_END) \
+		{ \
+			return NULL; \
+		} \
+		\
+		return Slot; \
+	} \
+	\
+	Type* Name##_Get(Name* This, SlotMapHandle Handle) \
+	{ \
+		SlotMapSlot* Slot = Name##_Resolve(This, Handle); \
+		\
+		return Slot != NULL ? &This->Data[Slot->DataIndex] : NULL; \
+	} \
+	\
+	int Name##_Remove(Name* This, SlotMapHandle Handle) \
+	{ \
+		SlotMapSlot* Slot = Name##_Resolve(This, Handle); \
+		\
+		if (Slot == NULL) \
+		{ \
+			return FALSE; \
+		} \
+		\
+		uint32_t DataIndex = Slot->DataIndex; \
+		uint32_t LastIndex = --This->Count; \
+		\
+		if (DataIndex != LastIndex) \
+		{ \
+			This->Data[DataIndex] = This->Data[LastIndex]; \
+			This->DataSlots[DataIndex] = This->DataSlots[LastIndex]; \
+			This->Slots[This->DataSlots[DataIndex]].DataIndex = DataIndex; \
+		} \
+		\
+		Slot->DataIndex = SLOT_MAP_FREE_END; \
+		Slot->Generation++; \
+		Slot->NextFree = This->FreeSlot; \
+		This->FreeSlot = Handle.Index; \
+		\
+		return TRUE; \
+	} \
+	\
+	SlotMapHandle Name##_GetHandle(Name* This, uint32_t DataIndex) \
+	{ \
+		if (DataIndex >= This->Count) \
+		{ \
+			return SlotMapHandle_Invalid; \
+		} \
+		\
+		uint32_t Index = This->DataSlots[DataIndex]; \
+		SlotMapHandle Handle = {Index, This->Slots[Index].Generation}; \
+		\
+		return Handle; \
+	} \
+	\
+	uint32_t Name##_Count(Name* This) \
+	{ \
+		return This->Count; \
+	} \
+	\
+	void Name##_Clear(Name* This) \
+	{ \
+		while (This->Count > 0) \
+		{ \
+			Name##_Remove(This, Name##_GetHandle(This, This->Count - 1)); \
+		} \
+	} \
+	\
+	void Name##_Wipeout(Name* This) \
+	{ \
+		free(This->Data); \
+		free(This->DataSlots); \
+		free(This->Slots); \
+		\
+		This->Data = NULL; \
+		This->DataSlots = NULL; \
+		This->Slots = NULL; \
+		This->Count = 0; \
+		This->DataMax = 0; \
+		This->SlotsCount = 0; \
+		This->SlotsMax = 0; \
+		This->FreeSlot = SLOT_MAP_FREE_END; \
+	} \
+	\
+	void Name##_Init(Name* This, uint32_t Expected) \
+	{ \
+		This->Data = NULL; \
+		This->DataSlots = NULL; \
+		This->Count = 0; \
+		This->DataMax = 0; \
+		This->Slots = NULL; \
+		This->SlotsCount = 0; \
+		This->SlotsMax = 0; \
+		This->FreeSlot = SLOT_MAP_FREE_END; \
+		\
+		while (This->DataMax < Expected) \
+		{ \
+			Name##_GrowData(This); \
+		} \
+	}
+
+#endif
@@ -24,21 +24,86 @@
 
 #include "Demo.h"
 
-static int KeepRefreshingRenderer(void* user_data)
+static void Demo_QueueRenderView(Demo* demo, ViewName Name)
+{
+	for (ViewViewport ViewportID = VIEW_VIEWPORT_A; ViewportID < VIEW_VIEWPORT_MAX; ViewportID++)
+	{
+		if (demo->MasterRenderer.ViewportViewNameMapping[ViewportID] == Name)
+		{
+			multi_gl_view_queue_render_view(MULTI_GL_VIEW(demo->multiglview), ViewportID);
+		}
+	}
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Runs once per frame of the widget frame clock while a camera
+// moves. The cameras advance by the real time between the
+// frames, the first frame by one refresh interval. A stall
+// (window hidden, debugger) is capped so an animation does not
+// jump to its end. The ticks stop with the last animation.
+
+#define DEMO_FRAME_TIME_MAX 0.1
+
+static gboolean Demo_OnTick(GtkWidget* Widget, GdkFrameClock* FrameClock, gpointer user_data)
 {
 	Demo* demo = (Demo*) user_data;
 	
-	if (demo->KeepRefreshingRenderer == TRUE)
+	gint64 FrameTime = gdk_frame_clock_get_frame_time(FrameClock);
+	float DeltaTime;
+	
+	if (demo->LastFrameTime == 0)
+	{
+		gint64 RefreshInterval = 0;
+		
+		gdk_frame_clock_get_refresh_info(FrameClock, FrameTime, &RefreshInterval, NULL);
+		DeltaTime = RefreshInterval > 0 ? RefreshInterval / 1000000.0 : 0.016;
+	}
+	else
+	{
+		DeltaTime = (FrameTime - demo->LastFrameTime) / 1000000.0;
+	}
+	
+	if (DeltaTime > DEMO_FRAME_TIME_MAX)
+	{
+		DeltaTime = DEMO_FRAME_TIME_MAX;
+	}
+	
+	demo->LastFrameTime = FrameTime;
+	
+	for (ViewName Index = VIEW_PERSPECTIVE; Index < VIEW_MAX; Index++)
 	{
-		for (ViewName Index = VIEW_PERSPECTIVE; Index < VIEW_MAX; Index++)
+		CameraControl* Camera = &demo->MasterRenderer.Cameras[Index];
+		
+		// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// Only the views showing a moving camera need a
+		// new frame, the others keep their last texture.
+		
+		if (Camera->Animation == CAMERA_CONTROL_ANIMATION_ACTIVE)
 		{
-			demo->MasterRenderer.Cameras[Index].Update(&demo->MasterRenderer.Cameras[Index], 0.016);
+			Camera->Update(Camera, DeltaTime);
+			Demo_QueueRenderView(demo, Index);
 		}
-		
-		multi_gl_view_queue_render(MULTI_GL_VIEW(demo->multiglview));
 	}
 	
-	return demo->KeepRefreshingRenderer;
+	if (RenderingEngine_IsAnimating(&demo->MasterRenderer))
+	{
+		return G_SOURCE_CONTINUE;
+	}
+	
+	demo->LastFrameTime = 0;
+	
+	return G_SOURCE_REMOVE;
+}
+
+// To be called after starting a camera animation, does nothing
+// if the ticks already run.
+
+static void Demo_StartAnimation(Demo* demo)
+{
+	if (RenderingEngine_IsAnimating(&demo->MasterRenderer))
+	{
+		demo->AnimationTicker.Launch(&demo->AnimationTicker, demo->multiglview);
+	}
 }
 
 static GMenuModel* Demo_CreateMenu(Demo* This, ViewViewport Index);
@@ -316,6 +381,39 @@ static void Demo_OnRender(MultiGLView *area, int Index, guint Fbo, int Width, in
 	RenderingEngine_Render(&demo->MasterRenderer, Index, Fbo, Width, Height);
 }
 
+static void Demo_OnRenderViews(MultiGLView *area, int Count, const int* Indices, const guint* Fbos, const int* Widths, const int* Heights, gpointer user_data)
+{
+	Demo* demo = (Demo*) user_data;
+	RenderingEngine_RenderViews(&demo->MasterRenderer, Count, Indices, Fbos, Widths, Heights);
+}
+
+static void Demo_OnFrameRendered(MultiGLView *area, guint RenderedViews, gpointer user_data)
+{
+	Demo* demo = (Demo*) user_data;
+	RenderingEngine_EndFrame(&demo->MasterRenderer);
+	
+	// Keep polling the shaders still compiling.
+	
+	if (RenderingEngine_HasPendingShaders(&demo->MasterRenderer))
+	{
+		multi_gl_view_queue_render(area);
+	}
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Editing a shader while the demo runs rebuilds it at the
+// next frame, a broken edit keeps the previous program.
+
+static void Demo_OnShaderChanged(const char* FileName, gpointer user_data)
+{
+	Demo* demo = (Demo*) user_data;
+	
+	if (RenderingEngine_ShaderSourceChanged(&demo->MasterRenderer, FileName))
+	{
+		multi_gl_view_queue_render(MULTI_GL_VIEW(demo->multiglview));
+	}
+}
+
 static void Demo_OnRealize(GtkWidget* Widget, void* user_data)
 {
 	Demo* demo = (Demo*) user_data;
@@ -330,17 +428,35 @@ static void Demo_OnRealize(GtkWidget* Widget, void* user_data)
 	
 	multi_gl_view_make_current(MULTI_GL_VIEW(demo->multiglview));
 	
+	// Linked shader programs are cached there, skipping the compilation on the next launches.
+	
+	char* CacheDirectory = g_build_filename(g_get_user_cache_dir(), "multi.gl.view.example", "shaders", NULL);
+	
+	if (g_mkdir_with_parents(CacheDirectory, 0700) == 0)
+	{
+		ShaderProgram_SetCacheDirectory(CacheDirectory);
+	}
+	
+	g_free(CacheDirectory);
+	
 	RenderingEngine_Initialize(&demo->MasterRenderer);
 	
-	demo->TimeoutRefreshRenderer.Launch(&demo->TimeoutRefreshRenderer);
+	demo->ShaderMonitor.Launch(&demo->ShaderMonitor);
+	
+	// The cameras move to their default views.
+	
+	Demo_StartAnimation(demo);
 }
 
 static void Demo_OnUnrealize(GtkWidget* Widget, void* user_data)
 {
 	Demo* demo = (Demo*) user_data;
 	
+	demo->ShaderMonitor.Cancel(&demo->ShaderMonitor);
+	demo->AnimationTicker.Cancel(&demo->AnimationTicker);
+	demo->LastFrameTime = 0;
+	
 	multi_gl_view_make_current(MULTI_GL_VIEW(demo->multiglview));
-	demo->KeepRefreshingRenderer = FALSE;
 	RenderingEngine_Wipeout(&demo->MasterRenderer);
 }
 
@@ -373,8 +489,10 @@ static void Demo_Activate(GtkApplication *app, gpointer user_data)
 	multi_gl_view_set_required_version(MULTI_GL_VIEW(demo->multiglview), 4, 3);
 	multi_gl_view_set_allowed_apis(MULTI_GL_VIEW(demo->multiglview), GDK_GL_API_GL);
 	multi_gl_view_set_render_callback(MULTI_GL_VIEW(demo->multiglview), Demo_OnRender, demo);
+	multi_gl_view_set_render_views_callback(MULTI_GL_VIEW(demo->multiglview), Demo_OnRenderViews, demo);
 	multi_gl_view_set_maximized(MULTI_GL_VIEW(demo->multiglview), FALSE);
 	g_signal_connect(G_OBJECT(demo->multiglview), "realize", G_CALLBACK(Demo_OnRealize), demo);
+	g_signal_connect(G_OBJECT(demo->multiglview), "frame-rendered", G_CALLBACK(Demo_OnFrameRendered), demo);
 	g_signal_connect(G_OBJECT(demo->multiglview), "unrealize", G_CALLBACK(Demo_OnUnrealize), demo);
 	
 	for (int i = 0; i < 5; i++)
@@ -390,6 +508,19 @@ static void Demo_Activate(GtkApplication *app, gpointer user_data)
 	gtk_menu_button_set_label(GTK_MENU_BUTTON(demo->menubutton[2]), "Front");
 	gtk_menu_button_set_label(GTK_MENU_BUTTON(demo->menubutton[3]), "Right");
 	
+	// DEMO_FRAME_STATS=1 shows the frame times over every view, each view
+	// rendered on its own to get its times.
+	
+	if (g_getenv("DEMO_FRAME_STATS") != NULL)
+	{
+		multi_gl_view_set_view_timing(MULTI_GL_VIEW(demo->multiglview), TRUE);
+		
+		for (int i = 0; i < 5; i++)
+		{
+			multi_gl_view_set_stats_overlay(MULTI_GL_VIEW(demo->multiglview), i, TRUE);
+		}
+	}
+	
 	gtk_box_append(GTK_BOX(demo->mainbox), demo->multiglview);
 	gtk_window_set_child(GTK_WINDOW (demo->window), demo->mainbox);
 	gtk_window_present (GTK_WINDOW (demo->window));
@@ -406,11 +537,12 @@ void Demo_Init(Demo* demo)
 	demo->app = NULL;
 	demo->window = NULL;
 	demo->multiglview = NULL;
-	demo->KeepRefreshingRenderer = TRUE;
+	demo->LastFrameTime = 0;
 	
 	RenderingEngine_Init(&demo->MasterRenderer);
 	
-	GTimeoutAddFull_Init(&demo->TimeoutRefreshRenderer, 0, 16, KeepRefreshingRenderer, demo);
+	GtkWidgetTickCallback_Init(&demo->AnimationTicker, Demo_OnTick, demo);
+	GFileMonitorDirectory_Init(&demo->ShaderMonitor, SHADER_PATH, Demo_OnShaderChanged, demo);
 	
 }
 
@@ -27,7 +27,8 @@
 
 #include <gtk/gtk.h>
 #include "MultiGLViewGtk.h"
-#include "GTimeoutAddFull.h"
+#include "GtkWidgetTickCallback.h"
+#include "GFileMonitorDirectory.h"
 
 #include "RenderingEngine.h"
 
@@ -46,9 +47,10 @@ struct Demo
 	GtkGesture *gesturedrag[5];
 	GtkEventController *event_control_scroll[5];
 	
-	GTimeoutAddFull TimeoutRefreshRenderer;
+	GtkWidgetTickCallback AnimationTicker;
+	GFileMonitorDirectory ShaderMonitor;
 	
-	int KeepRefreshingRenderer;
+	gint64 LastFrameTime;
 	RenderingEngine MasterRenderer;
 	
 	
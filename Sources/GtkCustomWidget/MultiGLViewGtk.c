@@ -22,23 +22,98 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include <epoxy/gl.h>
 
 #include "SimpleGLViewGtk.h"
 #include "MultiGLViewGtk.h"
+#include "Trace.h"
 
-typedef struct _View
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Every view renders into a small ring of textures so
+// that we never draw into a texture GSK may still be
+// sampling. The depth can be changed at runtime with
+// multi_gl_view_set_texture_ring_depth().
+
+#define MULTI_GL_VIEW_MIN_RING_DEPTH 2
+#define MULTI_GL_VIEW_MAX_RING_DEPTH 4
+#define MULTI_GL_VIEW_DEFAULT_RING_DEPTH 3
+
+typedef struct _View View;
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A slot is busy from the moment its GdkTexture is
+// built until GSK releases it. The fence must stay
+// alive just as long, so it is deleted on release.
+// Slots live on the heap and hold their own context
+// while busy : a slot still held by GSK when the
+// widget goes away is detached (view set to NULL)
+// and frees itself on release.
+
+typedef struct _ViewTexture
+{
+	View* view;
+	GdkGLContext* context;
+	GLuint TextureID;
+	int width, height;
+	gboolean in_use;
+	GLsync sync;
+	GdkTexture* gl_texture;
+} ViewTexture;
+
+struct _View
 {
     GLuint fbo;
     //GLuint depth_stencil_buffer;
     GLenum status;
     int width, height;
+    GdkGLContext* context;
     GdkGLTextureBuilder *builder;
-    GLuint TextureID;
+    ViewTexture* textures[MULTI_GL_VIEW_MAX_RING_DEPTH];
+    int current;
     GdkTexture* gl_texture;
    // GdkTexture* dmabuf_texture;
-} View;
+};
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// One dirty bit per view, the 4 small views followed
+// by the maximized one.
+
+#define MULTI_GL_VIEW_DIRTY_BIT(index) (1u << (index))
+#define MULTI_GL_VIEW_ALL_VIEWS 0x1Fu
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Histograms of 0.25 ms buckets up to 100 ms, the last
+// bucket takes everything longer. A frame coming more
+// than half a second after the previous one ends an
+// idle period and does not count as an interval.
+
+#define MULTI_GL_VIEW_STATS_BUCKETS 400
+#define MULTI_GL_VIEW_STATS_BUCKET_US 250
+#define MULTI_GL_VIEW_STATS_IDLE_US 500000
+#define MULTI_GL_VIEW_STATS_OVERLAY_US 250000
+
+typedef struct _StatsHistogram
+{
+	guint64 count;
+	guint counts[MULTI_GL_VIEW_STATS_BUCKETS + 1];
+} StatsHistogram;
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The GPU queries of the last frames. A query per view
+// plus one for a render views pass, a bit per query
+// still waiting for its result. A frame whose slot is
+// still pending is not timed rather than waited for.
+
+#define MULTI_GL_VIEW_GPU_TIMER_FRAMES 4
+#define MULTI_GL_VIEW_GPU_TIMER_PASS 5
+
+typedef struct _GpuTimerFrame
+{
+	GLuint queries[6];
+	guint pending;
+} GpuTimerFrame;
 
 typedef struct _MultiGLViewPrivate MultiGLViewPrivate;
 
@@ -51,18 +126,22 @@ struct _MultiGLViewPrivate
 	
 	int required_gl_version;
 	GdkGLAPI allowed_apis;
+	int texture_ring_depth;
 	
 	//gboolean have_depth_buffers;
 	//gboolean have_stencil_buffers;
 	gboolean needs_resize;
 	gboolean auto_render;
-	gboolean needs_render;
+	gboolean view_timing;
+	guint dirty_views;
 	//gboolean have_buffers;
 	gboolean maximized_mode;
 	
 	View views[5];
 	RenderCallback render_scene;
     void* userdata;	
+	RenderViewsCallback render_views;
+	void* render_views_userdata;
 	GtkWidget* main_paned;
 	GtkWidget* top_paned;
 	GtkWidget* bottom_paned;
@@ -71,26 +150,39 @@ struct _MultiGLViewPrivate
 	GtkWidget* small_views[4];
 	GtkWidget* maximize_view;
 	
-		
+	MultiGLViewStats stats;
+	StatsHistogram frame_interval_histogram;
+	StatsHistogram snapshot_cpu_histogram;
+	StatsHistogram render_gpu_histogram;
+	gint64 last_frame_time;
+	gboolean gpu_timing;
+	GpuTimerFrame gpu_frames[MULTI_GL_VIEW_GPU_TIMER_FRAMES];
+	int gpu_frame;
+	GtkWidget* stats_labels[5];
+	guint stats_overlay_source;
+	gint64 stats_overlay_time;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE(MultiGLView, multi_gl_view, GTK_TYPE_BOX)
 
 
+static void multi_gl_view_dispose(GObject* object);
 static GdkGLContext* multi_gl_view_create_context(MultiGLView*);
 static void multi_gl_view_realize(GtkWidget *widget);
 static void multi_gl_view_unrealize(GtkWidget *widget);
 static void multi_gl_view_size_allocate(GtkWidget *widget, int width, int height, int baseline);
 static void multi_gl_view_snapshot(GtkWidget* widget, GtkSnapshot* snapshot);
+static void multi_gl_view_free_view_texture(View* view, int index);
 
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-// An enum is created with 2 contants and an array
-// of only one element. It's being done that way for
-// future expansion.
+// "frame-rendered" is emitted once per snapshot that
+// rendered at least one view, with the GL context still
+// current and the mask of the rendered views.
 
 enum
 {
   CREATE_CONTEXT,
+  FRAME_RENDERED,
   LAST_SIGNAL
 };
 
@@ -109,7 +201,9 @@ static gboolean multi_gl_view_create_context_accumulator(GSignalInvocationHint *
 
 static void multi_gl_view_class_init(MultiGLViewClass* klass)
 {
-    //GObjectClass* object_class = G_OBJECT_CLASS(klass);
+    GObjectClass* object_class = G_OBJECT_CLASS(klass);
+    
+    object_class->dispose = multi_gl_view_dispose;
     
     klass->create_context = multi_gl_view_create_context;
     
@@ -129,6 +223,15 @@ static void multi_gl_view_class_init(MultiGLViewClass* klass)
                   multi_gl_view_create_context_accumulator, NULL,
                   g_cclosure_marshal_generic,
                   GDK_TYPE_GL_CONTEXT, 0);
+
+  multi_gl_view_signals[FRAME_RENDERED] =
+    g_signal_new ("frame-rendered",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 1, G_TYPE_UINT);
 }
 
 static GdkGLContext* multi_gl_view_create_context(MultiGLView* self) 
@@ -185,7 +288,7 @@ static void multi_gl_view_realize(GtkWidget *widget)
 	{
 		return;
 	}
-
+	
 	g_signal_emit(self, multi_gl_view_signals[CREATE_CONTEXT], 0, &private->context);
 	
 	if (private->context == NULL)
@@ -208,6 +311,8 @@ static void multi_gl_view_realize(GtkWidget *widget)
 	
     for (int ViewID = 0; ViewID < 5; ViewID++)
     {
+		private->views[ViewID].context = private->context;
+		g_clear_object(&private->views[ViewID].builder);
 		private->views[ViewID].builder = gdk_gl_texture_builder_new();
 		gdk_gl_texture_builder_set_context(private->views[ViewID].builder, GDK_GL_CONTEXT(private->context));
 		
@@ -215,7 +320,21 @@ static void multi_gl_view_realize(GtkWidget *widget)
 			gdk_gl_texture_builder_set_format (private->views[ViewID].builder, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
 		else
 			gdk_gl_texture_builder_set_format (private->views[ViewID].builder, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED);
-
+	
+	}
+	
+	// Timer queries are core since GL 3.3, GLES only has them as an extension.
+	
+	private->gpu_timing = !gdk_gl_context_get_use_es(private->context) && (epoxy_gl_version() >= 33 || epoxy_has_gl_extension("GL_ARB_timer_query"));
+	private->stats.gpu_timing = private->gpu_timing;
+	
+	if (private->gpu_timing)
+	{
+		for (int i = 0; i < MULTI_GL_VIEW_GPU_TIMER_FRAMES; i++)
+		{
+			glGenQueries(6, private->gpu_frames[i].queries);
+			private->gpu_frames[i].pending = 0;
+		}
 	}
 	
 	private->needs_resize = TRUE;
@@ -226,21 +345,163 @@ static void multi_gl_view_unrealize(GtkWidget *widget)
 	MultiGLView* self = MULTI_GL_VIEW(widget);
 	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
 	
+	if (private->context != NULL)
+	{
+		multi_gl_view_make_current(self);
+		
+		// Slots still shown by GSK free themselves on release.
+		
+		for (int ViewID = 0; ViewID < 5; ViewID++)
+		{
+			View* view = &private->views[ViewID];
+			
+			for (int TextureID = 0; TextureID < MULTI_GL_VIEW_MAX_RING_DEPTH; TextureID++)
+			{
+				multi_gl_view_free_view_texture(view, TextureID);
+			}
+			
+			if (view->fbo != 0)
+			{
+				glDeleteFramebuffers(1, &view->fbo);
+				view->fbo = 0;
+			}
+			
+			g_clear_object(&view->builder);
+			view->context = NULL;
+			view->gl_texture = NULL;
+			view->current = 0;
+			view->width = 0;
+			view->height = 0;
+		}
+	}
 	
+	if (private->gpu_timing)
+	{
+		for (int i = 0; i < MULTI_GL_VIEW_GPU_TIMER_FRAMES; i++)
+		{
+			glDeleteQueries(6, private->gpu_frames[i].queries);
+			private->gpu_frames[i].pending = 0;
+		}
+		
+		private->gpu_timing = FALSE;
+		private->stats.gpu_timing = FALSE;
+	}
 	
+	private->last_frame_time = 0;
+	
+	if (private->context != NULL)
+	{
+		if (private->context == gdk_gl_context_get_current())
+		{
+			gdk_gl_context_clear_current();
+		}
+		
+		g_clear_object(&private->context);
+	}
 	
 	GTK_WIDGET_CLASS(multi_gl_view_parent_class)->unrealize(widget);
 }
 
 static void multi_gl_view_release_gl_texture(gpointer data)
 {
-	View* view = data;
-    view->gl_texture = NULL;
+	ViewTexture* texture = data;
+	View* view = texture->view;
+	
+	// GDK contexts share their objects, any current one will do.
+	
+	if ((texture->sync != NULL || view == NULL) && gdk_gl_context_get_current() == NULL)
+	{
+		gdk_gl_context_make_current(texture->context);
+	}
+	
+	if (texture->sync != NULL)
+	{
+		glDeleteSync(texture->sync);
+		texture->sync = NULL;
+	}
+	
+	g_clear_object(&texture->context);
+	
+	// The widget let go of this slot, nobody else will reuse it.
+	
+	if (view == NULL)
+	{
+		glDeleteTextures(1, &texture->TextureID);
+		g_free(texture);
+		return;
+	}
+	
+	if (view->gl_texture == texture->gl_texture)
+	{
+		view->gl_texture = NULL;
+	}
+	
+	texture->gl_texture = NULL;
+	texture->in_use = FALSE;
 }
 
-static void multi_gl_view_ensure_view_buffer(View* view)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Hands a slot still held by GSK over to its release
+// callback. Returns TRUE when the slot was busy, the
+// caller owns it otherwise.
+
+static gboolean multi_gl_view_detach_view_texture(View* view, int index)
+{
+	ViewTexture* texture = view->textures[index];
+	
+	if (texture == NULL || !texture->in_use)
+	{
+		return FALSE;
+	}
+	
+	if (view->gl_texture == texture->gl_texture)
+	{
+		view->gl_texture = NULL;
+	}
+	
+	texture->view = NULL;
+	view->textures[index] = NULL;
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Frees a ring slot right away when it is idle, or once
+// GSK releases it. Needs the GL context to be current.
+
+static void multi_gl_view_free_view_texture(View* view, int index)
 {
+	if (multi_gl_view_detach_view_texture(view, index) || view->textures[index] == NULL)
+	{
+		return;
+	}
+	
+	glDeleteTextures(1, &view->textures[index]->TextureID);
+	g_clear_pointer(&view->textures[index], g_free);
+}
 
+static void multi_gl_view_dispose(GObject* object)
+{
+	MultiGLView* self = MULTI_GL_VIEW(object);
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	for (int ViewID = 0; ViewID < 5; ViewID++)
+	{
+		for (int TextureID = 0; TextureID < MULTI_GL_VIEW_MAX_RING_DEPTH; TextureID++)
+		{
+			if (!multi_gl_view_detach_view_texture(&private->views[ViewID], TextureID))
+			{
+				g_clear_pointer(&private->views[ViewID].textures[TextureID], g_free);
+			}
+		}
+	}
+	
+	G_OBJECT_CLASS(multi_gl_view_parent_class)->dispose(object);
+}
+
+static void multi_gl_view_ensure_view_buffer(View* view)
+{
+	
 	if (view->fbo == 0)
 	{
 		glGenFramebuffers (1, &view->fbo);
@@ -248,33 +509,51 @@ static void multi_gl_view_ensure_view_buffer(View* view)
 	
 } 
 
-static void multi_gl_view_ensure_view_texture(View* view)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Picks the next slot of the ring not held by GSK. Returns
+// NULL when every slot is still busy.
+
+static ViewTexture* multi_gl_view_acquire_view_texture(View* view, int depth)
 {
-	if (view->TextureID == 0)
-	{
-		glGenTextures(1, &view->TextureID);
-		gdk_gl_texture_builder_set_id(view->builder, view->TextureID);
-	}
-	else
+	for (int i = 1; i <= depth; i++)
 	{
-		glDeleteTextures(1, &view->TextureID);
-		glGenTextures(1, &view->TextureID);
-		gdk_gl_texture_builder_set_id(view->builder, view->TextureID);
+		int index = (view->current + i) % depth;
+		
+		if (view->textures[index] == NULL)
+		{
+			view->textures[index] = g_new0(ViewTexture, 1);
+			view->textures[index]->view = view;
+		}
+		
+		if (!view->textures[index]->in_use)
+		{
+			view->current = index;
+			return view->textures[index];
+		}
 	}
+	
+	return NULL;
 }
 
-static void multi_gl_view_allocate_view_texture(MultiGLView* self, View* view)
+static void multi_gl_view_allocate_view_texture(MultiGLView* self, View* view, ViewTexture* texture)
 {
 	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
-
-	if (gdk_gl_texture_builder_get_width(view->builder) != view->width || 
-		gdk_gl_texture_builder_get_height(view->builder) != view->height)
+	
+	if (texture->TextureID == 0)
 	{
-		glBindTexture (GL_TEXTURE_2D, gdk_gl_texture_builder_get_id(view->builder));
+		glGenTextures(1, &texture->TextureID);
+		glBindTexture (GL_TEXTURE_2D, texture->TextureID);
 		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+	
+	// The texture object is kept on resize, only its storage is replaced.
+	
+	if (texture->width != view->width || texture->height != view->height)
+	{
+		glBindTexture (GL_TEXTURE_2D, texture->TextureID);
 		
 		if (gdk_gl_context_get_api(private->context) == GDK_GL_API_GLES)
 		{
@@ -285,27 +564,30 @@ static void multi_gl_view_allocate_view_texture(MultiGLView* self, View* view)
 			glTexImage2D (GL_TEXTURE_2D, 0, GL_RGBA8, view->width, view->height, 0, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
 		}
 		
-		gdk_gl_texture_builder_set_width(view->builder, view->width);
-		gdk_gl_texture_builder_set_height(view->builder, view->height);
+		texture->width = view->width;
+		texture->height = view->height;
 	}
+	
+	gdk_gl_texture_builder_set_id(view->builder, texture->TextureID);
+	gdk_gl_texture_builder_set_width(view->builder, texture->width);
+	gdk_gl_texture_builder_set_height(view->builder, texture->height);
 }
 
-static void multi_gl_view_attach_view_buffer(View* view)
+static void multi_gl_view_attach_view_buffer(View* view, ViewTexture* texture)
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, view->fbo);
-		
-	if (view->TextureID > 0)
-	{
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gdk_gl_texture_builder_get_id(view->builder), 0);
-	}
-
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->TextureID, 0);
 	view->status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 }
 
 
 
 
-static void multi_gl_view_resize_view(MultiGLView* self, int ViewID, int width, int height) 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns TRUE when the view size changed, in which case
+// its content is stale and must be rendered again.
+
+static gboolean multi_gl_view_resize_view(MultiGLView* self, int ViewID, int width, int height) 
 {
 	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
   
@@ -313,26 +595,238 @@ static void multi_gl_view_resize_view(MultiGLView* self, int ViewID, int width,
 	
     if (view->width == width && view->height == height) 
     {
-		multi_gl_view_attach_view_buffer(view);
-		return;
+		return FALSE;
+	}
+	
+	view->width = width;
+	view->height = height;
+	
+	return TRUE;
+}
+
+static void multi_gl_view_get_visible_views(MultiGLView* self, int* first, int* last)
+{
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	if (!private->maximized_mode)
+	{
+		*first = 0;
+		*last = 4;
 	}
 	else
 	{
-		view->width = width;
-		view->height = height;
+		*first = 4;
+		*last = 5;
+	}
+}
+
+static void multi_gl_view_histogram_add(StatsHistogram* histogram, gint64 us)
+{
+	gint64 bucket = us / MULTI_GL_VIEW_STATS_BUCKET_US;
+	
+	histogram->counts[CLAMP(bucket, 0, MULTI_GL_VIEW_STATS_BUCKETS)]++;
+	histogram->count++;
+}
+
+// Returns the upper bound of the bucket holding the percentile, in ms.
+
+static double multi_gl_view_histogram_percentile(StatsHistogram* histogram, double percentile)
+{
+	if (histogram->count == 0)
+	{
+		return -1.0;
+	}
+	
+	guint64 rank = (guint64) (histogram->count * percentile + 0.5);
+	guint64 seen = 0;
+	int bucket;
+	
+	for (bucket = 0; bucket < MULTI_GL_VIEW_STATS_BUCKETS; bucket++)
+	{
+		seen += histogram->counts[bucket];
+		
+		if (seen >= rank)
+		{
+			break;
+		}
+	}
+	
+	return (bucket + 1) * MULTI_GL_VIEW_STATS_BUCKET_US / 1000.0;
+}
+
+static void multi_gl_view_histogram_percentiles(StatsHistogram* histogram, MultiGLViewPercentiles* percentiles)
+{
+	percentiles->p50 = multi_gl_view_histogram_percentile(histogram, 0.50);
+	percentiles->p95 = multi_gl_view_histogram_percentile(histogram, 0.95);
+	percentiles->p99 = multi_gl_view_histogram_percentile(histogram, 0.99);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Reads the results of the oldest frames first. The GPU
+// completes the queries in order, so the first frame not
+// ready ends the scan.
+
+static void multi_gl_view_collect_gpu_times(MultiGLView* self)
+{
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	for (int n = 1; n <= MULTI_GL_VIEW_GPU_TIMER_FRAMES; n++)
+	{
+		GpuTimerFrame* frame = &private->gpu_frames[(private->gpu_frame + n) % MULTI_GL_VIEW_GPU_TIMER_FRAMES];
+		
+		if (frame->pending == 0)
+		{
+			continue;
+		}
+		
+		GLuint available = GL_FALSE;
+		
+		for (int i = 0; i < 6; i++)
+		{
+			if (frame->pending & (1u << i))
+			{
+				glGetQueryObjectuiv(frame->queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+				
+				if (!available)
+				{
+					return;
+				}
+			}
+		}
+		
+		GLuint64 total = 0;
+		
+		for (int i = 0; i < 6; i++)
+		{
+			if (frame->pending & (1u << i))
+			{
+				GLuint64 elapsed = 0;
+				
+				glGetQueryObjectui64v(frame->queries[i], GL_QUERY_RESULT, &elapsed);
+				total += elapsed;
+				
+				if (i != MULTI_GL_VIEW_GPU_TIMER_PASS)
+				{
+					private->stats.view_gpu_ms[i] = elapsed / 1000000.0;
+				}
+			}
+		}
+		
+		frame->pending = 0;
+		private->stats.render_gpu_ms = total / 1000000.0;
+		multi_gl_view_histogram_add(&private->render_gpu_histogram, (gint64) (total / 1000));
+	}
+}
+
+// Returns NULL when this frame is not timed on the GPU.
+
+static GpuTimerFrame* multi_gl_view_begin_gpu_frame(MultiGLView* self)
+{
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	if (!private->gpu_timing)
+	{
+		return NULL;
 	}
 	
-	multi_gl_view_ensure_view_buffer(view);
-	multi_gl_view_ensure_view_texture(view);
-	multi_gl_view_allocate_view_texture(self, view);
-	multi_gl_view_attach_view_buffer(view);
+	multi_gl_view_collect_gpu_times(self);
+	
+	int next = (private->gpu_frame + 1) % MULTI_GL_VIEW_GPU_TIMER_FRAMES;
+	
+	if (private->gpu_frames[next].pending != 0)
+	{
+		return NULL;
+	}
+	
+	private->gpu_frame = next;
+	
+	return &private->gpu_frames[next];
+}
+
+static void multi_gl_view_update_stats_labels(MultiGLView* self)
+{
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	MultiGLViewStats stats;
+	
+	multi_gl_view_get_stats(self, &stats);
+	
+	for (int i = 0; i < 5; i++)
+	{
+		GtkWidget* label = private->stats_labels[i];
+		
+		if (label == NULL || !gtk_widget_get_visible(label))
+		{
+			continue;
+		}
+		
+		char* text = g_strdup_printf("CPU %.2f ms (p95 %.2f)  GPU %.2f ms (p95 %.2f)\n"
+									 "View CPU %.2f ms  GPU %.2f ms\n"
+									 "Interval p50 %.2f  p95 %.2f  p99 %.2f ms",
+									 stats.snapshot_cpu_ms, stats.snapshot_cpu.p95,
+									 stats.render_gpu_ms, stats.render_gpu.p95,
+									 stats.view_cpu_ms[i], stats.view_gpu_ms[i],
+									 stats.frame_interval.p50, stats.frame_interval.p95, stats.frame_interval.p99);
+		
+		gtk_label_set_text(GTK_LABEL(label), text);
+		g_free(text);
+	}
+}
+
+static gboolean multi_gl_view_on_stats_overlay_idle(gpointer user_data)
+{
+	MultiGLView* self = MULTI_GL_VIEW(user_data);
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	private->stats_overlay_source = 0;
+	multi_gl_view_update_stats_labels(self);
+	
+	return G_SOURCE_REMOVE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Called after each rendered frame. The labels are not
+// touched during the snapshot, their relayout is left to
+// an idle, and a frame where nothing renders schedules
+// nothing, so the overlay never keeps the widget drawing.
+
+static void multi_gl_view_record_frame(MultiGLView* self, gint64 frame_time, gint64 snapshot_us, gint64 render_us)
+{
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	if (private->last_frame_time != 0 && frame_time - private->last_frame_time <= MULTI_GL_VIEW_STATS_IDLE_US)
+	{
+		multi_gl_view_histogram_add(&private->frame_interval_histogram, frame_time - private->last_frame_time);
+	}
+	
+	private->last_frame_time = frame_time;
+	
+	private->stats.frames++;
+	private->stats.snapshot_cpu_ms = snapshot_us / 1000.0;
+	private->stats.render_cpu_ms = render_us / 1000.0;
+	multi_gl_view_histogram_add(&private->snapshot_cpu_histogram, snapshot_us);
+	
+	gint64 now = g_get_monotonic_time();
+	gboolean has_labels = FALSE;
+	
+	for (int i = 0; i < 5; i++)
+	{
+		has_labels |= private->stats_labels[i] != NULL && gtk_widget_get_visible(private->stats_labels[i]);
+	}
+	
+	if (has_labels && private->stats_overlay_source == 0 && now - private->stats_overlay_time >= MULTI_GL_VIEW_STATS_OVERLAY_US)
+	{
+		private->stats_overlay_time = now;
+		private->stats_overlay_source = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, multi_gl_view_on_stats_overlay_idle, g_object_ref(self), g_object_unref);
+	}
 }
 
 static void multi_gl_view_snapshot(GtkWidget* widget, GtkSnapshot* snapshot) 
 {
+	TRACE_SCOPE("multi_gl_view_snapshot");
+	
 	MultiGLView* self = MULTI_GL_VIEW(widget);
 	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
-
+	
 	if (private->error) 
 	{
 		for (int i = 0; i < 5; i++) 
@@ -347,7 +841,7 @@ static void multi_gl_view_snapshot(GtkWidget* widget, GtkSnapshot* snapshot)
 			}
 		}
 		
-		private->needs_render = FALSE;
+		private->dirty_views = 0;
 		
 		// Delegate to parent (GtkBox) to snapshot children
 		GTK_WIDGET_CLASS(multi_gl_view_parent_class)->snapshot(widget, snapshot);
@@ -355,131 +849,190 @@ static void multi_gl_view_snapshot(GtkWidget* widget, GtkSnapshot* snapshot)
 		return;
 	}
 	
-	
-
-	
-	if (private->needs_render && private->render_scene && private->context) 
+	if (private->dirty_views != 0 && (private->render_scene || private->render_views) && private->context) 
 	{
+		int first, last;
+		int count = 0;
+		int indices[5];
+		guint fbos[5];
+		int widths[5];
+		int heights[5];
+		guint rendered_views = 0;
+		ViewTexture* textures[5] = {NULL, NULL, NULL, NULL, NULL};
+		gint64 snapshot_start = g_get_monotonic_time();
+		gint64 render_us = 0;
+		
+		multi_gl_view_get_visible_views(self, &first, &last);
 		multi_gl_view_make_current(self);
 		
-		if (!private->maximized_mode)
+		for (int i = first; i < last; i++) 
 		{
-			for (int i = 0; i < 4; i++) 
+			GtkWidget* view_widget = multi_gl_view_get_view_widget(self, i);
+			int s = gtk_widget_get_scale_factor(view_widget);
+			int w = gtk_widget_get_width(view_widget) * s;
+			int h = gtk_widget_get_height(view_widget) * s;
+			
+			// A view without a size yet stays dirty until it gets one.
+			
+			if (w <= 0 || h <= 0) 
 			{
-				int s = gtk_widget_get_scale_factor(private->small_views[i]);
-				int w = gtk_widget_get_width(private->small_views[i]) * s;
-				int h = gtk_widget_get_height(private->small_views[i]) * s;
-				
-				if (w > 0 && h > 0) 
-				{
-					multi_gl_view_resize_view(self, i, w, h); 
-				}
-				else
-				{
-					return;
-				}
+				continue;
+			}
 			
+			if (multi_gl_view_resize_view(self, i, w, h))
+			{
+				private->dirty_views |= MULTI_GL_VIEW_DIRTY_BIT(i);
 			}
-		}
-		else
-		{
-			int s = gtk_widget_get_scale_factor(private->maximize_view);
-			int w = gtk_widget_get_width(private->maximize_view) * s;
-			int h = gtk_widget_get_height(private->maximize_view) * s;
 			
-			if (w > 0 && h > 0) 
+			if (!(private->dirty_views & MULTI_GL_VIEW_DIRTY_BIT(i)))
 			{
-				multi_gl_view_resize_view(self, 4, w, h); 
+				continue;
 			}
-			else
+			
+			// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+			// When GSK still holds every texture of the ring,
+			// the view stays dirty and we try again next frame.
+			
+			textures[i] = multi_gl_view_acquire_view_texture(&private->views[i], private->texture_ring_depth);
+			
+			if (textures[i] == NULL)
+			{
+				gtk_widget_queue_draw(widget);
+				continue;
+			}
+			
+			multi_gl_view_ensure_view_buffer(&private->views[i]);
+			multi_gl_view_allocate_view_texture(self, &private->views[i], textures[i]);
+			multi_gl_view_attach_view_buffer(&private->views[i], textures[i]);
+			
+			if (private->views[i].status != GL_FRAMEBUFFER_COMPLETE)
 			{
-				return;
+				g_warning("Framebuffer setup not complete (%d)", private->views[i].status);
 			}
+			
+			indices[count] = i;
+			fbos[count] = private->views[i].fbo;
+			widths[count] = private->views[i].width;
+			heights[count] = private->views[i].height;
+			count++;
 		}
 		
-		if (!private->maximized_mode)
+		GpuTimerFrame* gpu_frame = count > 0 ? multi_gl_view_begin_gpu_frame(self) : NULL;
+		
+		if (count > 0 && private->render_views && !(private->view_timing && private->render_scene))
 		{
-			for (int i = 0; i < 4; i++) 
+			gint64 start = g_get_monotonic_time();
+			
+			// Timed as a whole, the per view times would be stale.
+			
+			for (int n = 0; n < count; n++)
 			{
-				if (private->views[i].status != GL_FRAMEBUFFER_COMPLETE)
-				{
-					g_warning("Framebuffer setup not complete (%d)", private->views[i].status);
-				}
+				private->stats.view_cpu_ms[indices[n]] = -1.0;
+				private->stats.view_gpu_ms[indices[n]] = -1.0;
 			}
-		}
-		else
-		{
-			if (private->views[4].status != GL_FRAMEBUFFER_COMPLETE)
+			
+			if (gpu_frame != NULL)
 			{
-				g_warning("Framebuffer setup not complete (%d)", private->views[4].status);
+				glBeginQuery(GL_TIME_ELAPSED, gpu_frame->queries[MULTI_GL_VIEW_GPU_TIMER_PASS]);
 			}
-		}
-		
-		if (!private->maximized_mode)
-		{
-			for (int i = 0; i < 4; i++) 
+			
+			private->render_views(self, count, indices, fbos, widths, heights, private->render_views_userdata);
+			
+			if (gpu_frame != NULL)
 			{
-				private->render_scene(self, i, private->views[i].fbo, private->views[i].width, private->views[i].height, private->userdata);
+				glEndQuery(GL_TIME_ELAPSED);
+				gpu_frame->pending |= 1u << MULTI_GL_VIEW_GPU_TIMER_PASS;
 			}
+			
+			render_us = g_get_monotonic_time() - start;
 		}
 		else
 		{
-			private->render_scene(self, 4, private->views[4].fbo, private->views[4].width, private->views[4].height, private->userdata);
-		}
-
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glFinish();
-		
-		//GdkDmabuf dmabuf;
-
-		gpointer sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-		
-		if (!private->maximized_mode)
-		{
-			for (int i = 0; i < 4; i++) 
+			for (int n = 0; n < count && private->render_scene; n++)
 			{
-				gdk_gl_texture_builder_set_sync(GDK_GL_TEXTURE_BUILDER(private->views[i].builder), sync);
+				gint64 start = g_get_monotonic_time();
+				
+				if (gpu_frame != NULL)
+				{
+					glBeginQuery(GL_TIME_ELAPSED, gpu_frame->queries[indices[n]]);
+				}
+				
+				private->render_scene(self, indices[n], fbos[n], widths[n], heights[n], private->userdata);
 				
-				private->views[i].gl_texture = gdk_gl_texture_builder_build(GDK_GL_TEXTURE_BUILDER(private->views[i].builder),
-															  multi_gl_view_release_gl_texture, (void*) &private->views[i]);
+				if (gpu_frame != NULL)
+				{
+					glEndQuery(GL_TIME_ELAPSED);
+					gpu_frame->pending |= 1u << indices[n];
+				}
 				
-				simple_gl_view_set_texture(SIMPLE_GL_VIEW(private->small_views[i]), private->views[i].gl_texture);
+				gint64 elapsed = g_get_monotonic_time() - start;
+				
+				private->stats.view_cpu_ms[indices[n]] = elapsed / 1000.0;
+				render_us += elapsed;
 			}
 		}
-		else
+		
+		// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// One fence per view, GSK waits on it on the GPU
+		// instead of us stalling the CPU with glFinish().
+		
+		for (int n = 0; n < count; n++)
 		{
-			gdk_gl_texture_builder_set_sync(GDK_GL_TEXTURE_BUILDER(private->views[4].builder), sync);
-				
-			private->views[4].gl_texture = gdk_gl_texture_builder_build(private->views[4].builder,
-															  multi_gl_view_release_gl_texture, (void*) &private->views[4]);
-				
-			simple_gl_view_set_texture(SIMPLE_GL_VIEW(private->maximize_view), private->views[4].gl_texture);
+			textures[indices[n]]->sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			rendered_views |= MULTI_GL_VIEW_DIRTY_BIT(indices[n]);
 		}
-
 		
-		if (sync)
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		
+		if (rendered_views != 0)
 		{
-			glDeleteSync(sync);
+			// Make the fences visible to the GSK context.
 			
-			if (!private->maximized_mode)
+			glFlush();
+			
+			//GdkDmabuf dmabuf;
+			
+			for (int i = first; i < last; i++) 
 			{
-				for (int i = 0; i < 4; i++) 
+				if (!(rendered_views & MULTI_GL_VIEW_DIRTY_BIT(i)))
 				{
-					gdk_gl_texture_builder_set_sync(private->views[i].builder, NULL);
+					continue;
 				}
+				
+				ViewTexture* texture = textures[i];
+				
+				gdk_gl_texture_builder_set_sync(private->views[i].builder, texture->sync);
+				
+				texture->in_use = TRUE;
+				texture->context = g_object_ref(private->context);
+				texture->gl_texture = gdk_gl_texture_builder_build(private->views[i].builder,
+																  multi_gl_view_release_gl_texture, texture);
+				
+				gdk_gl_texture_builder_set_sync(private->views[i].builder, NULL);
+				private->views[i].gl_texture = texture->gl_texture;
+				
+				// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+				// The SimpleGLView holds the only reference from
+				// here on, so a clean view keeps showing its last
+				// texture until a new one replaces it.
+				
+				simple_gl_view_set_texture(SIMPLE_GL_VIEW(multi_gl_view_get_view_widget(self, i)), texture->gl_texture);
+				g_object_unref(texture->gl_texture);
 			}
-			else
-			{
-				gdk_gl_texture_builder_set_sync(private->views[4].builder, NULL);
-			}
+			
+			g_signal_emit(self, multi_gl_view_signals[FRAME_RENDERED], 0, rendered_views);
+			
+			GdkFrameClock* frame_clock = gtk_widget_get_frame_clock(widget);
+			gint64 now = g_get_monotonic_time();
+			
+			multi_gl_view_record_frame(self, frame_clock != NULL ? gdk_frame_clock_get_frame_time(frame_clock) : now, now - snapshot_start, render_us);
 		}
 		
-		private->needs_render = FALSE;
-		
-		// Delegate to parent (GtkBox) to snapshot children
-		GTK_WIDGET_CLASS(multi_gl_view_parent_class)->snapshot(widget, snapshot);
+		private->dirty_views &= ~rendered_views;
 	}
-
+	
+	// Delegate to parent (GtkBox) to snapshot children
+	GTK_WIDGET_CLASS(multi_gl_view_parent_class)->snapshot(widget, snapshot);
 }
 
 static void multi_gl_view_size_allocate(GtkWidget *widget, int width, int height, int baseline)
@@ -493,27 +1046,23 @@ static void multi_gl_view_size_allocate(GtkWidget *widget, int width, int height
 	{
 		return;
 	}
-
-	if (!private->maximized_mode)
+	
+	int first, last;
+	
+	multi_gl_view_get_visible_views(self, &first, &last);
+	
+	for (int i = first; i < last; i++) 
 	{
-		for (int i = 0; i < 4; i++) 
+		GtkWidget* view_widget = multi_gl_view_get_view_widget(self, i);
+		int s = gtk_widget_get_scale_factor(view_widget);
+		int w = gtk_widget_get_width(view_widget) * s;
+		int h = gtk_widget_get_height(view_widget) * s;
+		
+		if (w > 0 && h > 0 && multi_gl_view_resize_view(self, i, w, h))
 		{
-			int s = gtk_widget_get_scale_factor(private->small_views[i]);
-            int w = gtk_widget_get_width(private->small_views[i]) * s;
-            int h = gtk_widget_get_height(private->small_views[i]) * s;
-            if (w > 0 && h > 0) multi_gl_view_resize_view(self, i, w, h);
-        }
-	}
-	else
-	{
-		int s = gtk_widget_get_scale_factor(private->maximize_view);
-		int w = gtk_widget_get_width(private->maximize_view) * s;
-		int h = gtk_widget_get_height(private->maximize_view) * s;
-		if (w > 0 && h > 0) multi_gl_view_resize_view(self, 4, w, h);
+			multi_gl_view_queue_render_view(self, i);
+		}
 	}
-	
-	multi_gl_view_queue_render(self);
-	
 }
 
 static void multi_gl_view_init(MultiGLView* self)
@@ -525,11 +1074,13 @@ static void multi_gl_view_init(MultiGLView* self)
 	//private->have_buffers = FALSE;
 	private->required_gl_version = 0;
 	private->allowed_apis = GDK_GL_API_GL | GDK_GL_API_GLES;
+	private->texture_ring_depth = MULTI_GL_VIEW_DEFAULT_RING_DEPTH;
 	
 	private->needs_resize = TRUE;
 	private->auto_render = TRUE;
-	private->needs_render = TRUE;
-
+	private->view_timing = FALSE;
+	private->dirty_views = MULTI_GL_VIEW_ALL_VIEWS;
+	
 	private->main_paned = NULL;
 	private->top_paned = NULL;
 	private->bottom_paned = NULL;
@@ -553,16 +1104,42 @@ static void multi_gl_view_init(MultiGLView* self)
 		private->views[ViewID].fbo = 0;
 		private->views[ViewID].width = 0;
 		private->views[ViewID].height = 0;
+		private->views[ViewID].context = NULL;
 		private->views[ViewID].builder = NULL;
-		private->views[ViewID].TextureID = 0;
+		private->views[ViewID].current = 0;
 		private->views[ViewID].gl_texture = NULL;
+		
+		// Slots are allocated on first use.
+		
+		for (int TextureID = 0; TextureID < MULTI_GL_VIEW_MAX_RING_DEPTH; TextureID++)
+		{
+			private->views[ViewID].textures[TextureID] = NULL;
+		}
 		//private->views[ViewID].dmabuf_texture = NULL;
 	}
 	
     private->render_scene = NULL;
     private->userdata = NULL;
+    private->render_views = NULL;
+    private->render_views_userdata = NULL;
     
+    private->gpu_timing = FALSE;
+    private->gpu_frame = 0;
     
+    for (int i = 0; i < MULTI_GL_VIEW_GPU_TIMER_FRAMES; i++)
+    {
+		private->gpu_frames[i].pending = 0;
+	}
+	
+	for (int i = 0; i < 5; i++)
+	{
+		private->stats_labels[i] = NULL;
+	}
+	
+	private->stats_overlay_source = 0;
+	private->stats_overlay_time = 0;
+	
+	multi_gl_view_reset_stats(self);
 }
 
 void multi_gl_view_get_required_version(MultiGLView* self, int *major, int *minor)
@@ -613,6 +1190,43 @@ void multi_gl_view_set_allowed_apis(MultiGLView* self, GdkGLAPI apis)
 	private->allowed_apis = apis;
 }
 
+int multi_gl_view_get_texture_ring_depth(MultiGLView* self)
+{
+	g_return_val_if_fail(IS_MULTI_GL_VIEW(self), 0);
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	return private->texture_ring_depth;
+}
+
+void multi_gl_view_set_texture_ring_depth(MultiGLView* self, int depth)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	private->texture_ring_depth = CLAMP(depth, MULTI_GL_VIEW_MIN_RING_DEPTH, MULTI_GL_VIEW_MAX_RING_DEPTH);
+	
+	// Slots past the new depth are never picked again.
+	
+	if (private->context == NULL)
+	{
+		return;
+	}
+	
+	multi_gl_view_make_current(self);
+	
+	for (int ViewID = 0; ViewID < 5; ViewID++)
+	{
+		for (int TextureID = private->texture_ring_depth; TextureID < MULTI_GL_VIEW_MAX_RING_DEPTH; TextureID++)
+		{
+			multi_gl_view_free_view_texture(&private->views[ViewID], TextureID);
+		}
+		
+		private->views[ViewID].current %= private->texture_ring_depth;
+	}
+}
+
 gboolean multi_gl_view_get_auto_render(MultiGLView* self)
 {
 	g_return_val_if_fail(IS_MULTI_GL_VIEW(self), FALSE);
@@ -635,6 +1249,23 @@ void multi_gl_view_set_auto_render(MultiGLView* self, gboolean auto_render)
     }
 }
 
+gboolean multi_gl_view_get_view_timing(MultiGLView* self)
+{
+	g_return_val_if_fail(IS_MULTI_GL_VIEW(self), FALSE);
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	return private->view_timing;
+}
+
+void multi_gl_view_set_view_timing(MultiGLView* self, gboolean view_timing)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	private->view_timing = !!view_timing;
+}
+
 GtkWidget* multi_gl_view_get_view_widget(MultiGLView* self, int index)
 {
 	g_return_val_if_fail(IS_MULTI_GL_VIEW(self), NULL);
@@ -693,7 +1324,9 @@ void multi_gl_view_set_maximized(MultiGLView* self, gboolean maximized)
 		gtk_widget_set_visible(private->maximize_view_overlay, TRUE);		
 	}
 	
-	gtk_widget_queue_draw(GTK_WIDGET(self));
+	// The views being shown were not rendered while hidden.
+	
+	multi_gl_view_queue_render(self);
 }
 
 GError* multi_gl_view_get_error(MultiGLView* self)
@@ -731,11 +1364,101 @@ void multi_gl_view_set_render_callback(MultiGLView* self, RenderCallback render_
 	private->userdata = userdata;
 }
 
+void multi_gl_view_set_render_views_callback(MultiGLView* self, RenderViewsCallback render_views, void* userdata)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	private->render_views = render_views;
+	private->render_views_userdata = userdata;
+}
+
+void multi_gl_view_get_stats(MultiGLView* self, MultiGLViewStats* stats)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	g_return_if_fail(stats != NULL);
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	*stats = private->stats;
+	
+	multi_gl_view_histogram_percentiles(&private->frame_interval_histogram, &stats->frame_interval);
+	multi_gl_view_histogram_percentiles(&private->snapshot_cpu_histogram, &stats->snapshot_cpu);
+	multi_gl_view_histogram_percentiles(&private->render_gpu_histogram, &stats->render_gpu);
+}
+
+// The GPU queries in flight are kept, their results land in the new statistics.
+
+void multi_gl_view_reset_stats(MultiGLView* self)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	memset(&private->frame_interval_histogram, 0, sizeof(StatsHistogram));
+	memset(&private->snapshot_cpu_histogram, 0, sizeof(StatsHistogram));
+	memset(&private->render_gpu_histogram, 0, sizeof(StatsHistogram));
+	
+	private->stats.frames = 0;
+	private->stats.gpu_timing = private->gpu_timing;
+	private->stats.snapshot_cpu_ms = -1.0;
+	private->stats.render_cpu_ms = -1.0;
+	private->stats.render_gpu_ms = -1.0;
+	
+	for (int i = 0; i < 5; i++)
+	{
+		private->stats.view_cpu_ms[i] = -1.0;
+		private->stats.view_gpu_ms[i] = -1.0;
+	}
+	
+	private->last_frame_time = 0;
+}
+
+void multi_gl_view_set_stats_overlay(MultiGLView* self, int index, gboolean visible)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	g_return_if_fail(index >= 0 && index < 5);
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	
+	if (private->stats_labels[index] == NULL)
+	{
+		if (!visible)
+		{
+			return;
+		}
+		
+		private->stats_labels[index] = gtk_label_new(NULL);
+		gtk_widget_set_can_target(private->stats_labels[index], FALSE);
+		gtk_widget_add_css_class(private->stats_labels[index], "monospace");
+		gtk_widget_add_css_class(private->stats_labels[index], "osd");
+		multi_gl_view_add_overlay(self, index, private->stats_labels[index]);
+		gtk_widget_set_valign(private->stats_labels[index], GTK_ALIGN_END);
+	}
+	
+	gtk_widget_set_visible(private->stats_labels[index], visible);
+	
+	if (visible)
+	{
+		multi_gl_view_update_stats_labels(self);
+	}
+}
+
 void multi_gl_view_queue_render(MultiGLView* self)
 {
 	g_return_if_fail(IS_MULTI_GL_VIEW(self));
 	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
-	private->needs_render = TRUE;
+	private->dirty_views = MULTI_GL_VIEW_ALL_VIEWS;
+	gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void multi_gl_view_queue_render_view(MultiGLView* self, int index)
+{
+	g_return_if_fail(IS_MULTI_GL_VIEW(self));
+	g_return_if_fail(index >= 0 && index < 5);
+	
+	MultiGLViewPrivate* private = multi_gl_view_get_instance_private(self);
+	private->dirty_views |= MULTI_GL_VIEW_DIRTY_BIT(index);
 	gtk_widget_queue_draw(GTK_WIDGET(self));
 }
 
@@ -45,6 +45,12 @@ struct _MultiGLViewClass
 
 typedef void (*RenderCallback)(MultiGLView*, int, guint, int, int, void*);
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Receives every view to render this frame at once: the count, then parallel
+// arrays of view indices, framebuffers, widths and heights.
+
+typedef void (*RenderViewsCallback)(MultiGLView*, int, const int*, const guint*, const int*, const int*, void*);
+
 GtkWidget* multi_gl_view_new(void);
 
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -59,6 +65,13 @@ void multi_gl_view_set_required_version(MultiGLView* self, int major, int minor)
 GdkGLAPI multi_gl_view_get_allowed_apis(MultiGLView* self);
 void multi_gl_view_set_allowed_apis(MultiGLView* self, GdkGLAPI apis);
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Number of textures each view cycles through (2 to 4, 3 by default). A view
+// never renders into a texture GSK is still holding.
+
+int multi_gl_view_get_texture_ring_depth(MultiGLView* self);
+void multi_gl_view_set_texture_ring_depth(MultiGLView* self, int depth);
+
 gboolean multi_gl_view_get_auto_render(MultiGLView* self);
 void multi_gl_view_set_auto_render(MultiGLView* self, gboolean auto_render);
 
@@ -77,7 +90,71 @@ void multi_gl_view_set_maximized(MultiGLView* self, gboolean maximized);
 
 void multi_gl_view_set_render_callback(MultiGLView* self, RenderCallback render_scene, void* userdata);
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// When set, used instead of the render callback so a renderer can draw all the
+// dirty views in a single pass.
+
+void multi_gl_view_set_render_views_callback(MultiGLView* self, RenderViewsCallback render_views, void* userdata);
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Frame statistics, always collected. Times are in milliseconds, a negative time
+// was not measured. The CPU times come from the monotonic clock, the GPU times
+// from GL_TIME_ELAPSED queries read a few frames later without stalling (desktop
+// GL 3.3 or ARB_timer_query only, the render callbacks must not run their own
+// GL_TIME_ELAPSED query). The percentiles cover every frame since the last reset,
+// with a 0.25 ms precision.
+
+typedef struct _MultiGLViewPercentiles
+{
+	double p50;
+	double p95;
+	double p99;
+} MultiGLViewPercentiles;
+
+typedef struct _MultiGLViewStats
+{
+	guint64 frames;
+	gboolean gpu_timing;
+	
+	double snapshot_cpu_ms;
+	double render_cpu_ms;
+	double render_gpu_ms;
+	
+	// -1 while the views go through a render views callback, timed as a whole
+	// in render_cpu_ms and render_gpu_ms. Turn view timing on to get them.
+	
+	double view_cpu_ms[5];
+	double view_gpu_ms[5];
+	
+	MultiGLViewPercentiles frame_interval;
+	MultiGLViewPercentiles snapshot_cpu;
+	MultiGLViewPercentiles render_gpu;
+} MultiGLViewStats;
+
+void multi_gl_view_get_stats(MultiGLView* self, MultiGLViewStats* stats);
+void multi_gl_view_reset_stats(MultiGLView* self);
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// With view timing on (off by default), the dirty views go through the render
+// callback one by one even when a render views callback is set, so each one
+// gets its own CPU and GPU time. The batched submission is given up meanwhile.
+
+gboolean multi_gl_view_get_view_timing(MultiGLView* self);
+void multi_gl_view_set_view_timing(MultiGLView* self, gboolean view_timing);
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Shows the statistics in a label at the bottom of the view, refreshed at most
+// 4 times per second and only after a rendered frame.
+
+void multi_gl_view_set_stats_overlay(MultiGLView* self, int index, gboolean visible);
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// queue_render marks every view dirty, queue_render_view only the given one
+// (0 to 3 for the small views, 4 for the maximized view). Clean views keep
+// displaying their last texture without calling the render callback.
+
 void multi_gl_view_queue_render(MultiGLView* self);
+void multi_gl_view_queue_render_view(MultiGLView* self, int index);
 void multi_gl_view_make_current(MultiGLView* self);                                                  
 
 G_END_DECLS
@@ -91,8 +91,7 @@ static void simple_gl_view_snapshot(GtkWidget* widget, GtkSnapshot* snapshot)
     gtk_snapshot_append_texture(snapshot, self->gl_texture, &bounds);
     gtk_snapshot_restore(snapshot);
     
-    g_object_unref(self->gl_texture);
-    self->gl_texture = NULL; // Clear the pointer
+    // The texture is kept so the view can be redrawn without a new render.
 }
 
 static void simple_gl_view_class_init(SimpleGLViewClass* klass) 
@@ -0,0 +1,94 @@
+/*
+ * GFileMonitorDirectory.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+
+#include "GFileMonitorDirectory.h"
+
+static void GFileMonitorDirectory_OnChanged(GFileMonitor* Monitor, GFile* File, GFile* OtherFile, GFileMonitorEvent Event, gpointer user_data)
+{
+	GFileMonitorDirectory* This = (GFileMonitorDirectory*) user_data;
+	
+	// Renames report the new name as the other file.
+	
+	if (Event == G_FILE_MONITOR_EVENT_RENAMED && OtherFile != NULL)
+	{
+		File = OtherFile;
+	}
+	else if (Event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT && Event != G_FILE_MONITOR_EVENT_CREATED && Event != G_FILE_MONITOR_EVENT_MOVED_IN)
+	{
+		return;
+	}
+	
+	gchar* FileName = g_file_get_basename(File);
+	
+	if (FileName != NULL)
+	{
+		This->Function(FileName, This->Data);
+		g_free(FileName);
+	}
+}
+
+gboolean GFileMonitorDirectory_Launch(GFileMonitorDirectory* This)
+{
+	if (This->Monitor != NULL)
+	{
+		return TRUE;
+	}
+	
+	GError* Error = NULL;
+	GFile* Directory = g_file_new_for_path(This->Path);
+	
+	This->Monitor = g_file_monitor_directory(Directory, G_FILE_MONITOR_WATCH_MOVES, NULL, &Error);
+	g_object_unref(Directory);
+	
+	if (This->Monitor == NULL)
+	{
+		g_printerr("GFileMonitorDirectory->Launch() : %s : %s\n", This->Path, Error->message);
+		g_error_free(Error);
+		return FALSE;
+	}
+	
+	g_signal_connect(This->Monitor, "changed", G_CALLBACK(GFileMonitorDirectory_OnChanged), This);
+	
+	return TRUE;
+}
+
+void GFileMonitorDirectory_Cancel(GFileMonitorDirectory* This)
+{
+	if (This->Monitor != NULL)
+	{
+		g_file_monitor_cancel(This->Monitor);
+		g_clear_object(&This->Monitor);
+	}
+}
+
+void GFileMonitorDirectory_Init(GFileMonitorDirectory* This, const char* Path, GFileMonitorDirectoryFunc Function, gpointer Data)
+{
+	This->Launch = GFileMonitorDirectory_Launch;
+	This->Cancel = GFileMonitorDirectory_Cancel;
+	
+	This->Monitor = NULL;
+	This->Path = g_strdup(Path);
+	This->Function = Function;
+	This->Data = Data;
+}
@@ -0,0 +1,50 @@
+/*
+ * GFileMonitorDirectory.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef G_FILE_MONITOR_DIRECTORY_H
+#define G_FILE_MONITOR_DIRECTORY_H
+
+#include <gio/gio.h> 
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Watches the files of a directory, Function gets the base
+// name of every file written, created or moved in. Editors
+// saving through a temporary file and a rename are covered.
+
+typedef void (*GFileMonitorDirectoryFunc)(const char*, gpointer);
+
+typedef struct GFileMonitorDirectory GFileMonitorDirectory;
+
+struct GFileMonitorDirectory
+{
+	GFileMonitor* Monitor;
+	gchar* Path;
+	GFileMonitorDirectoryFunc Function;
+	gpointer Data;
+	gboolean (*Launch)(GFileMonitorDirectory*);
+	void (*Cancel)(GFileMonitorDirectory*);
+};
+
+void GFileMonitorDirectory_Init(GFileMonitorDirectory*, const char*, GFileMonitorDirectoryFunc, gpointer);
+	
+#endif
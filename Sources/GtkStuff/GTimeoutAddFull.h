@@ -1,45 +0,0 @@
-/*
- * GTimeoutAddFull.h
- * 
- * Copyright 2024 Guillaume Saumure <gsaumure@cgocable.ca>
- * 
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
- * MA 02110-1301, USA.
- * 
- * 
- */
-
-#ifndef G_TIMEOUT_ADD_FULL_H
-#define G_TIMEOUT_ADD_FULL_H
-
-#include <glib.h> 
-
-typedef struct GTimeoutAddFull GTimeoutAddFull;
-
-struct GTimeoutAddFull
-{
-	guint ID;
-	gint Priority;
-	guint Interval;
-	GSourceFunc Function;
-	gpointer Data;
-	guint (*GetID)(GTimeoutAddFull*);
-	void (*Launch)(GTimeoutAddFull*);
-};
-
-void GTimeoutAddFull_Init(GTimeoutAddFull*, gint, guint, GSourceFunc, gpointer);
-	
-#endif
-
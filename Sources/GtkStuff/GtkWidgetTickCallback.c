@@ -0,0 +1,78 @@
+/*
+ * GtkWidgetTickCallback.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+
+#include "GtkWidgetTickCallback.h"
+
+// GTK drops the callback by itself on G_SOURCE_REMOVE, only
+// the ID has to be forgotten.
+
+static gboolean GtkWidgetTickCallback_OnTick(GtkWidget* Widget, GdkFrameClock* FrameClock, gpointer user_data)
+{
+	GtkWidgetTickCallback* This = (GtkWidgetTickCallback*) user_data;
+	
+	if (This->Function(Widget, FrameClock, This->Data) == G_SOURCE_REMOVE)
+	{
+		This->ID = 0;
+		return G_SOURCE_REMOVE;
+	}
+	
+	return G_SOURCE_CONTINUE;
+}
+
+gboolean GtkWidgetTickCallback_IsRunning(GtkWidgetTickCallback* This)
+{
+	return This->ID != 0;
+}
+
+void GtkWidgetTickCallback_Launch(GtkWidgetTickCallback* This, GtkWidget* Widget)
+{
+	if (This->ID != 0)
+	{
+		return;
+	}
+	
+	This->Widget = Widget;
+	This->ID = gtk_widget_add_tick_callback(Widget, GtkWidgetTickCallback_OnTick, This, NULL);
+}
+
+void GtkWidgetTickCallback_Cancel(GtkWidgetTickCallback* This)
+{
+	if (This->ID != 0)
+	{
+		gtk_widget_remove_tick_callback(This->Widget, This->ID);
+		This->ID = 0;
+	}
+}
+
+void GtkWidgetTickCallback_Init(GtkWidgetTickCallback* This, GtkTickCallback Function, gpointer Data)
+{
+	This->IsRunning = GtkWidgetTickCallback_IsRunning;
+	This->Launch = GtkWidgetTickCallback_Launch;
+	This->Cancel = GtkWidgetTickCallback_Cancel;
+	
+	This->Widget = NULL;
+	This->ID = 0;
+	This->Function = Function;
+	This->Data = Data;
+}
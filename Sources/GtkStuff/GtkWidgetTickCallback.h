@@ -0,0 +1,50 @@
+/*
+ * GtkWidgetTickCallback.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef GTK_WIDGET_TICK_CALLBACK_H
+#define GTK_WIDGET_TICK_CALLBACK_H
+
+#include <gtk/gtk.h> 
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Calls Function once per frame of the widget frame clock,
+// until it returns G_SOURCE_REMOVE or Cancel() is called.
+// Nothing runs while the widget is not mapped. Launch() on a
+// running callback does nothing.
+
+typedef struct GtkWidgetTickCallback GtkWidgetTickCallback;
+
+struct GtkWidgetTickCallback
+{
+	GtkWidget* Widget;
+	guint ID;
+	GtkTickCallback Function;
+	gpointer Data;
+	gboolean (*IsRunning)(GtkWidgetTickCallback*);
+	void (*Launch)(GtkWidgetTickCallback*, GtkWidget*);
+	void (*Cancel)(GtkWidgetTickCallback*);
+};
+
+void GtkWidgetTickCallback_Init(GtkWidgetTickCallback*, GtkTickCallback, gpointer);
+	
+#endif
@@ -0,0 +1,169 @@
+/*
+ * HeadlessMain.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HeadlessRenderer.h"
+#include "Trace.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// make headless && ./headless -o Views.png
+//
+// -o PATH     output image, .png, .ppm or else raw RGBA8
+// -s WxH      image size, 800x800 by default
+// -v VIEW     a single view (perspective, front, back, top,
+//             bottom, left, right) instead of the 4 views
+// -n FRAMES   frames rendered and timed after the image
+// -c DIR      shader cache directory
+
+static const char* HeadlessViewNames[VIEW_MAX] = {"perspective", "front", "back", "top", "bottom", "left", "right"};
+
+static void HeadlessMain_Usage(const char* Program)
+{
+	fprintf(stderr, "Usage : %s [-o PATH] [-s WxH] [-v VIEW] [-n FRAMES] [-c DIR]\n", Program);
+}
+
+static double HeadlessMain_Now(void)
+{
+	struct timespec Time;
+	
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return Time.tv_sec + Time.tv_nsec / 1000000000.0;
+}
+
+int main(int argc, char** argv)
+{
+	const char* Path = "headless.png";
+	const char* CacheDirectory = NULL;
+	int Width = 800;
+	int Height = 800;
+	int SingleView = -1;
+	int FramesCount = 0;
+	int Option;
+	
+	TRACE_INIT("headless-trace.json");
+	
+	while ((Option = getopt(argc, argv, "o:s:v:n:c:")) != -1)
+	{
+		switch (Option)
+		{
+			case 'o':
+				Path = optarg;
+				break;
+				
+			case 's':
+				if (sscanf(optarg, "%dx%d", &Width, &Height) != 2 || Width <= 1 || Height <= 1)
+				{
+					HeadlessMain_Usage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				break;
+				
+			case 'v':
+				for (int Index = 0; Index < VIEW_MAX; Index++)
+				{
+					if (strcmp(optarg, HeadlessViewNames[Index]) == 0)
+					{
+						SingleView = Index;
+					}
+				}
+				
+				if (SingleView == -1)
+				{
+					HeadlessMain_Usage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				break;
+				
+			case 'n':
+				FramesCount = atoi(optarg);
+				break;
+				
+			case 'c':
+				CacheDirectory = optarg;
+				break;
+				
+			default:
+				HeadlessMain_Usage(argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	
+	HeadlessView Views[VIEW_VIEWPORT_MAX];
+	int ViewsCount;
+	
+	if (SingleView == -1)
+	{
+		HeadlessRenderer_SetQuadLayout(Views, Width, Height);
+		ViewsCount = 4;
+	}
+	else
+	{
+		HeadlessRenderer_SetSingleLayout(Views, (ViewName) SingleView, Width, Height);
+		ViewsCount = 1;
+	}
+	
+	if (CacheDirectory != NULL)
+	{
+		ShaderProgram_SetCacheDirectory(CacheDirectory);
+	}
+	
+	HeadlessRenderer Renderer;
+	
+	HeadlessRenderer_Init(&Renderer);
+	
+	if (HeadlessRenderer_Initialize(&Renderer, Width, Height, ViewsCount, Views) == FALSE || HeadlessRenderer_Settle(&Renderer, 30.0) == FALSE)
+	{
+		HeadlessRenderer_Wipeout(&Renderer);
+		return EXIT_FAILURE;
+	}
+	
+	printf("%s\n", (const char*) glGetString(GL_RENDERER));
+	
+	HeadlessRenderer_ReadPixels(&Renderer);
+	
+	int Result = HeadlessRenderer_WriteImage(&Renderer, Path, HeadlessRenderer_GuessFormat(Path));
+	
+	if (FramesCount > 0)
+	{
+		double Start = HeadlessMain_Now();
+		
+		for (int Frame = 0; Frame < FramesCount; Frame++)
+		{
+			HeadlessRenderer_Render(&Renderer);
+		}
+		
+		glFinish();
+		
+		printf("%d frames, %.3f ms per frame\n", FramesCount, (HeadlessMain_Now() - Start) * 1000.0 / FramesCount);
+	}
+	
+	HeadlessRenderer_Wipeout(&Renderer);
+	
+	return Result == TRUE ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,501 @@
+/*
+ * HeadlessRenderer.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <png.h>
+
+#include "HeadlessRenderer.h"
+
+static double HeadlessRenderer_Now(void)
+{
+	struct timespec Time;
+	
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return Time.tv_sec + Time.tv_nsec / 1000000000.0;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The surfaceless platform needs neither X11 nor Wayland
+// nor a DRM device. Without it, the default display.
+
+static EGLDisplay HeadlessRenderer_GetDisplay(void)
+{
+	EGLDisplay Display = EGL_NO_DISPLAY;
+	
+	if (epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless") && epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_EXT_platform_base"))
+	{
+		Display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	
+	if (Display == EGL_NO_DISPLAY)
+	{
+		Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	
+	return Display;
+}
+
+static int HeadlessRenderer_CreateContext(HeadlessRenderer* This)
+{
+	EGLint Major, Minor;
+	
+	This->Display = HeadlessRenderer_GetDisplay();
+	
+	if (This->Display == EGL_NO_DISPLAY || !eglInitialize(This->Display, &Major, &Minor))
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : No EGL display !\n");
+		return FALSE;
+	}
+	
+	if (!epoxy_has_egl_extension(This->Display, "EGL_KHR_surfaceless_context"))
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : EGL_KHR_surfaceless_context is not supported !\n");
+		return FALSE;
+	}
+	
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : Desktop OpenGL is not supported !\n");
+		return FALSE;
+	}
+	
+	// Nothing is drawn to an EGL surface, any config rendering GL will do.
+	
+	EGLConfig Config = NULL;
+	EGLint ConfigsCount = 0;
+	EGLint ConfigAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE};
+	
+	if (!epoxy_has_egl_extension(This->Display, "EGL_KHR_no_config_context") && (!eglChooseConfig(This->Display, ConfigAttributes, &Config, 1, &ConfigsCount) || ConfigsCount == 0))
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : No EGL config !\n");
+		return FALSE;
+	}
+	
+	EGLint ContextAttributes[] = 
+	{
+		EGL_CONTEXT_MAJOR_VERSION, HEADLESS_RENDERER_GL_MAJOR,
+		EGL_CONTEXT_MINOR_VERSION, HEADLESS_RENDERER_GL_MINOR,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	
+	This->Context = eglCreateContext(This->Display, Config != NULL ? Config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, ContextAttributes);
+	
+	if (This->Context == EGL_NO_CONTEXT)
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : No OpenGL %d.%d core context (0x%x) !\n", HEADLESS_RENDERER_GL_MAJOR, HEADLESS_RENDERER_GL_MINOR, eglGetError());
+		return FALSE;
+	}
+	
+	if (!eglMakeCurrent(This->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, This->Context))
+	{
+		fprintf(stderr, "HeadlessRenderer->CreateContext() : eglMakeCurrent failure (0x%x) !\n", eglGetError());
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+// The engine resolves the views into these, color only.
+
+static void HeadlessRenderer_CreateTargets(HeadlessRenderer* This)
+{
+	glGenFramebuffers(This->ViewsCount, This->Fbos);
+	glGenRenderbuffers(This->ViewsCount, This->Renderbuffers);
+	
+	for (int Index = 0; Index < This->ViewsCount; Index++)
+	{
+		glBindRenderbuffer(GL_RENDERBUFFER, This->Renderbuffers[Index]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, This->Views[Index].Width, This->Views[Index].Height);
+		
+		glBindFramebuffer(GL_FRAMEBUFFER, This->Fbos[Index]);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, This->Renderbuffers[Index]);
+		
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			fprintf(stderr, "HeadlessRenderer->CreateTargets() : Framebuffer not complete ! : %d x %d\n", This->Views[Index].Width, This->Views[Index].Height);
+		}
+	}
+	
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+static void HeadlessRenderer_DeleteTargets(HeadlessRenderer* This)
+{
+	if (This->ViewsCount > 0)
+	{
+		glDeleteFramebuffers(This->ViewsCount, This->Fbos);
+		glDeleteRenderbuffers(This->ViewsCount, This->Renderbuffers);
+		This->ViewsCount = 0;
+	}
+}
+
+static int HeadlessRenderer_CheckLayout(int Width, int Height, int ViewsCount, const HeadlessView* Views)
+{
+	if (ViewsCount < 1 || ViewsCount > VIEW_VIEWPORT_MAX)
+	{
+		fprintf(stderr, "HeadlessRenderer->CheckLayout() : %d views, 1 to %d expected !\n", ViewsCount, VIEW_VIEWPORT_MAX);
+		return FALSE;
+	}
+	
+	for (int Index = 0; Index < ViewsCount; Index++)
+	{
+		const HeadlessView* View = &Views[Index];
+		
+		if (View->Width <= 0 || View->Height <= 0 || View->X < 0 || View->Y < 0 || View->X + View->Width > Width || View->Y + View->Height > Height)
+		{
+			fprintf(stderr, "HeadlessRenderer->CheckLayout() : View %d is outside of the %d x %d image !\n", Index, Width, Height);
+			return FALSE;
+		}
+	}
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The views are mapped before the engine initialization,
+// the cameras of the mapped views get their default
+// position there. Returns FALSE if no GL context could be
+// made or the layout does not fit the image.
+
+int HeadlessRenderer_Initialize(HeadlessRenderer* This, int Width, int Height, int ViewsCount, const HeadlessView* Views)
+{
+	if (HeadlessRenderer_CheckLayout(Width, Height, ViewsCount, Views) == FALSE || HeadlessRenderer_CreateContext(This) == FALSE)
+	{
+		return FALSE;
+	}
+	
+	for (int Index = 0; Index < ViewsCount; Index++)
+	{
+		RenderingEngine_ViewportViewNameMapping(&This->Engine, Views[Index].ViewportID, Views[Index].Name);
+	}
+	
+	RenderingEngine_Initialize(&This->Engine);
+	
+	return HeadlessRenderer_SetLayout(This, Width, Height, ViewsCount, Views);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Replaces the layout of an initialized renderer, keeping
+// the context and the compiled shaders. The cameras are
+// left where they are.
+
+int HeadlessRenderer_SetLayout(HeadlessRenderer* This, int Width, int Height, int ViewsCount, const HeadlessView* Views)
+{
+	if (HeadlessRenderer_CheckLayout(Width, Height, ViewsCount, Views) == FALSE)
+	{
+		return FALSE;
+	}
+	
+	HeadlessRenderer_DeleteTargets(This);
+	
+	if (Width != This->Width || Height != This->Height)
+	{
+		free(This->Pixels);
+		This->Pixels = calloc((size_t) Width * Height, 4);
+		
+		if (This->Pixels == NULL)
+		{
+			fprintf(stderr, "HeadlessRenderer->SetLayout() : Pixels allocation failure !\n");
+			exit(EXIT_FAILURE);
+		}
+		
+		This->Width = Width;
+		This->Height = Height;
+	}
+	
+	// Like SwitchMode, a forgotten viewport size makes the next render
+	// hand its size to the camera now mapped there.
+	
+	for (int Index = 0; Index < ViewsCount; Index++)
+	{
+		This->Views[Index] = Views[Index];
+		RenderingEngine_ViewportViewNameMapping(&This->Engine, Views[Index].ViewportID, Views[Index].Name);
+		This->Engine.Widths[Views[Index].ViewportID] = 0;
+		This->Engine.Heights[Views[Index].ViewportID] = 0;
+	}
+	
+	This->ViewsCount = ViewsCount;
+	HeadlessRenderer_CreateTargets(This);
+	
+	return TRUE;
+}
+
+// The 2 x 2 layout of MultiGLView, A and B on top.
+
+void HeadlessRenderer_SetQuadLayout(HeadlessView* Views, int Width, int Height)
+{
+	static const ViewName Names[4] = {VIEW_TOP, VIEW_PERSPECTIVE, VIEW_FRONT, VIEW_RIGHT};
+	
+	for (int Index = 0; Index < 4; Index++)
+	{
+		int Column = Index % 2;
+		int Row = Index / 2;
+		
+		Views[Index].ViewportID = (ViewViewport) Index;
+		Views[Index].Name = Names[Index];
+		Views[Index].X = Column * (Width / 2);
+		Views[Index].Y = Row * (Height / 2);
+		Views[Index].Width = Column == 0 ? Width / 2 : Width - Width / 2;
+		Views[Index].Height = Row == 0 ? Height / 2 : Height - Height / 2;
+	}
+}
+
+void HeadlessRenderer_SetSingleLayout(HeadlessView* Views, ViewName Name, int Width, int Height)
+{
+	Views[0].ViewportID = VIEW_VIEWPORT_E;
+	Views[0].Name = Name;
+	Views[0].X = 0;
+	Views[0].Y = 0;
+	Views[0].Width = Width;
+	Views[0].Height = Height;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Brings the scene to the state a user would see: the
+// camera animations jump to their end and frames are
+// rendered until the shaders compiling in the background
+// are linked. Returns FALSE if they are still pending
+// after Timeout seconds.
+
+int HeadlessRenderer_Settle(HeadlessRenderer* This, double Timeout)
+{
+	for (ViewName Index = VIEW_PERSPECTIVE; Index < VIEW_MAX; Index++)
+	{
+		CameraControl* Camera = &This->Engine.Cameras[Index];
+		
+		for (int Step = 0; Step < 1000 && Camera->Animation == CAMERA_CONTROL_ANIMATION_ACTIVE; Step++)
+		{
+			Camera->Update(Camera, 1.0f);
+		}
+	}
+	
+	double Start = HeadlessRenderer_Now();
+	
+	HeadlessRenderer_Render(This);
+	
+	while (RenderingEngine_HasPendingShaders(&This->Engine))
+	{
+		if (HeadlessRenderer_Now() - Start > Timeout)
+		{
+			fprintf(stderr, "HeadlessRenderer->Settle() : Shaders still pending after %.1f s !\n", Timeout);
+			return FALSE;
+		}
+		
+		nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = 1000000}, NULL);
+		HeadlessRenderer_Render(This);
+	}
+	
+	return TRUE;
+}
+
+void HeadlessRenderer_Render(HeadlessRenderer* This)
+{
+	int ViewportIDs[VIEW_VIEWPORT_MAX];
+	int Widths[VIEW_VIEWPORT_MAX];
+	int Heights[VIEW_VIEWPORT_MAX];
+	
+	for (int Index = 0; Index < This->ViewsCount; Index++)
+	{
+		ViewportIDs[Index] = This->Views[Index].ViewportID;
+		Widths[Index] = This->Views[Index].Width;
+		Heights[Index] = This->Views[Index].Height;
+	}
+	
+	RenderingEngine_RenderViews(&This->Engine, This->ViewsCount, ViewportIDs, This->Fbos, Widths, Heights);
+	RenderingEngine_EndFrame(&This->Engine);
+}
+
+// GL rows go upward, the image rows downward.
+
+void HeadlessRenderer_ReadPixels(HeadlessRenderer* This)
+{
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glPixelStorei(GL_PACK_ROW_LENGTH, This->Width);
+	
+	for (int Index = 0; Index < This->ViewsCount; Index++)
+	{
+		HeadlessView* View = &This->Views[Index];
+		int Bottom = This->Height - View->Y - View->Height;
+		
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, This->Fbos[Index]);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glReadPixels(0, 0, View->Width, View->Height, GL_RGBA, GL_UNSIGNED_BYTE, This->Pixels + ((size_t) Bottom * This->Width + View->X) * 4);
+	}
+	
+	glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	
+	size_t Stride = (size_t) This->Width * 4;
+	unsigned char* Row = malloc(Stride);
+	
+	if (Row == NULL)
+	{
+		fprintf(stderr, "HeadlessRenderer->ReadPixels() : Row allocation failure !\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	for (int Y = 0; Y < This->Height / 2; Y++)
+	{
+		unsigned char* Top = This->Pixels + Y * Stride;
+		unsigned char* Bottom = This->Pixels + (This->Height - 1 - Y) * Stride;
+		
+		memcpy(Row, Top, Stride);
+		memcpy(Top, Bottom, Stride);
+		memcpy(Bottom, Row, Stride);
+	}
+	
+	free(Row);
+}
+
+static int HeadlessRenderer_WritePPM(HeadlessRenderer* This, FILE* File)
+{
+	fprintf(File, "P6\n%d %d\n255\n", This->Width, This->Height);
+	
+	for (size_t Index = 0; Index < (size_t) This->Width * This->Height; Index++)
+	{
+		fwrite(This->Pixels + Index * 4, 1, 3, File);
+	}
+	
+	return ferror(File) == 0;
+}
+
+// Raw is the Pixels buffer as is, RGBA8 rows from the top.
+
+int HeadlessRenderer_WriteImage(HeadlessRenderer* This, const char* Path, HeadlessImageFormat Format)
+{
+	if (Format == HEADLESS_IMAGE_PNG)
+	{
+		png_image Image;
+		
+		memset(&Image, 0, sizeof(png_image));
+		Image.version = PNG_IMAGE_VERSION;
+		Image.width = This->Width;
+		Image.height = This->Height;
+		Image.format = PNG_FORMAT_RGBA;
+		
+		if (!png_image_write_to_file(&Image, Path, 0, This->Pixels, 0, NULL))
+		{
+			fprintf(stderr, "HeadlessRenderer->WriteImage() : %s : %s\n", Path, Image.message);
+			return FALSE;
+		}
+		
+		return TRUE;
+	}
+	
+	FILE* File = fopen(Path, "wb");
+	
+	if (File == NULL)
+	{
+		fprintf(stderr, "HeadlessRenderer->WriteImage() : Could not open %s !\n", Path);
+		return FALSE;
+	}
+	
+	int Result;
+	
+	if (Format == HEADLESS_IMAGE_PPM)
+	{
+		Result = HeadlessRenderer_WritePPM(This, File);
+	}
+	else
+	{
+		Result = fwrite(This->Pixels, (size_t) This->Width * 4, This->Height, File) == (size_t) This->Height;
+	}
+	
+	if (fclose(File) != 0 || Result == FALSE)
+	{
+		fprintf(stderr, "HeadlessRenderer->WriteImage() : WriteFile failure ! : %s\n", Path);
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+HeadlessImageFormat HeadlessRenderer_GuessFormat(const char* Path)
+{
+	const char* Extension = strrchr(Path, '.');
+	
+	if (Extension != NULL && strcasecmp(Extension, ".png") == 0)
+	{
+		return HEADLESS_IMAGE_PNG;
+	}
+	
+	if (Extension != NULL && strcasecmp(Extension, ".ppm") == 0)
+	{
+		return HEADLESS_IMAGE_PPM;
+	}
+	
+	return HEADLESS_IMAGE_RAW;
+}
+
+void HeadlessRenderer_Wipeout(HeadlessRenderer* This)
+{
+	if (This->Context != EGL_NO_CONTEXT)
+	{
+		eglMakeCurrent(This->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, This->Context);
+		
+		RenderingEngine_Wipeout(&This->Engine);
+		HeadlessRenderer_DeleteTargets(This);
+		
+		eglMakeCurrent(This->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(This->Display, This->Context);
+		This->Context = EGL_NO_CONTEXT;
+	}
+	
+	if (This->Display != EGL_NO_DISPLAY)
+	{
+		eglTerminate(This->Display);
+		This->Display = EGL_NO_DISPLAY;
+	}
+	
+	free(This->Pixels);
+	This->Pixels = NULL;
+	This->Width = 0;
+	This->Height = 0;
+	This->ViewsCount = 0;
+}
+
+void HeadlessRenderer_Init(HeadlessRenderer* This)
+{
+	This->Display = EGL_NO_DISPLAY;
+	This->Context = EGL_NO_CONTEXT;
+	This->Width = 0;
+	This->Height = 0;
+	This->ViewsCount = 0;
+	This->Pixels = NULL;
+	
+	for (int Index = 0; Index < VIEW_VIEWPORT_MAX; Index++)
+	{
+		This->Fbos[Index] = 0;
+		This->Renderbuffers[Index] = 0;
+	}
+	
+	RenderingEngine_Init(&This->Engine);
+}
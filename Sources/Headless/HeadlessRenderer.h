@@ -0,0 +1,91 @@
+/*
+ * HeadlessRenderer.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef HEADLESS_RENDERER_H
+#define HEADLESS_RENDERER_H
+
+#include <epoxy/egl.h>
+
+#include "RenderingEngine.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Runs the RenderingEngine without GTK nor a window. The
+// context is an EGL surfaceless one, on the Mesa
+// surfaceless platform when available, so it also works
+// on llvmpipe without a GPU (LIBGL_ALWAYS_SOFTWARE=1
+// forces it).
+//
+// The layout places each view in one output image of
+// Width x Height, every view renders into its own FBO and
+// is read back into Pixels, RGBA8 rows from the top.
+
+#define HEADLESS_RENDERER_GL_MAJOR 4
+#define HEADLESS_RENDERER_GL_MINOR 3
+
+typedef enum
+{
+	HEADLESS_IMAGE_PNG,
+	HEADLESS_IMAGE_PPM,
+	HEADLESS_IMAGE_RAW
+} HeadlessImageFormat;
+
+typedef struct HeadlessView
+{
+	ViewViewport ViewportID;
+	ViewName Name;
+	int X;
+	int Y;
+	int Width;
+	int Height;
+} HeadlessView;
+
+typedef struct HeadlessRenderer HeadlessRenderer;
+
+struct HeadlessRenderer
+{
+	EGLDisplay Display;
+	EGLContext Context;
+	RenderingEngine Engine;
+	
+	int Width;
+	int Height;
+	int ViewsCount;
+	HeadlessView Views[VIEW_VIEWPORT_MAX];
+	GLuint Fbos[VIEW_VIEWPORT_MAX];
+	GLuint Renderbuffers[VIEW_VIEWPORT_MAX];
+	unsigned char* Pixels;
+};
+
+int HeadlessRenderer_Initialize(HeadlessRenderer*, int, int, int, const HeadlessView*);
+int HeadlessRenderer_SetLayout(HeadlessRenderer*, int, int, int, const HeadlessView*);
+void HeadlessRenderer_SetQuadLayout(HeadlessView*, int, int);
+void HeadlessRenderer_SetSingleLayout(HeadlessView*, ViewName, int, int);
+int HeadlessRenderer_Settle(HeadlessRenderer*, double);
+void HeadlessRenderer_Render(HeadlessRenderer*);
+void HeadlessRenderer_ReadPixels(HeadlessRenderer*);
+int HeadlessRenderer_WriteImage(HeadlessRenderer*, const char*, HeadlessImageFormat);
+HeadlessImageFormat HeadlessRenderer_GuessFormat(const char*);
+void HeadlessRenderer_Wipeout(HeadlessRenderer*);
+void HeadlessRenderer_Init(HeadlessRenderer*);
+
+#endif
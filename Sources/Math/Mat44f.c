@@ -24,6 +24,7 @@
 #include <math.h>
 
 #include "Mat44f.h"
+#include "Mat44fBackend.h"
 
 void Mat44f_SetLine1(Mat44f* This, float e11, float e12, float e13, float e14)
 {
@@ -118,6 +119,11 @@ void Mat44f_Subtract(Mat44f* This, Mat44f* Other)
 }
 
 void Mat44f_Multiply(Mat44f* This, Mat44f* Other)
+{
+	Mat44f_Backend->Multiply(This, Other);
+}
+
+void Mat44f_MultiplyScalar(Mat44f* This, Mat44f* Other)
 {
 	float e11 = This->e11 * Other->e11 + This->e12 * Other->e21 + This->e13 * Other->e31 + This->e14 * Other->e41;
 	float e12 = This->e11 * Other->e12 + This->e12 * Other->e22 + This->e13 * Other->e32 + This->e14 * Other->e42;
@@ -181,6 +187,11 @@ void Mat44f_ProductByScalar(Mat44f* This, float Scalar)
 }
 
 void Mat44f_ProductMatrixVector(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
+{
+	Mat44f_Backend->ProductMatrixVector(This, Vector, NewVector);
+}
+
+void Mat44f_ProductMatrixVectorScalar(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
 {
 
 	float X = This->e11 * Vector->X + This->e12 * Vector->Y + This->e13 * Vector->Z + This->e14 * Vector->W;
@@ -195,6 +206,11 @@ void Mat44f_ProductMatrixVector(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
 }
 
 void Mat44f_Transpose(Mat44f* This)
+{
+	Mat44f_Backend->Transpose(This);
+}
+
+void Mat44f_TransposeScalar(Mat44f* This)
 {
 	float Temp = This->e21;
 	This->e21 = This->e12;
@@ -254,6 +270,11 @@ float Mat44f_Determinant(Mat44f* This)
 }
 
 int Mat44f_Inverse(Mat44f* This, Mat44f* Inverse)
+{
+	return Mat44f_Backend->Inverse(This, Inverse);
+}
+
+int Mat44f_InverseScalar(Mat44f* This, Mat44f* Inverse)
 {
 	float Cofactor00 = Cofactor(This->e22, This->e32, This->e42, This->e23, This->e33, This->e43, This->e24, This->e34, This->e44);
 	float Cofactor01 = Cofactor(This->e12, This->e32, This->e42, This->e13, This->e33, This->e43, This->e14, This->e34, This->e44);
@@ -308,6 +329,66 @@ int Mat44f_Inverse(Mat44f* This, Mat44f* Inverse)
 	return 1;
 }
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Inverse of [A t ; 0 1] : [inv(A) -inv(A)t ; 0 1]. Only the
+// 3x3 part is inverted, the last line of This is ignored.
+
+int Mat44f_InverseAffine(Mat44f* This, Mat44f* Inverse)
+{
+	float Cofactor11 = This->e22 * This->e33 - This->e23 * This->e32;
+	float Cofactor12 = This->e23 * This->e31 - This->e21 * This->e33;
+	float Cofactor13 = This->e21 * This->e32 - This->e22 * This->e31;
+	
+	float Determinant = This->e11 * Cofactor11 + This->e12 * Cofactor12 + This->e13 * Cofactor13;
+	
+	if (fabsf(Determinant) <= 0.00001f)
+	{
+		Mat44f_Identity(Inverse);
+		return 0;
+	}
+	
+	float InvDeterminant = 1.0f / Determinant;
+	
+	float e11 = Cofactor11 * InvDeterminant;
+	float e12 = (This->e13 * This->e32 - This->e12 * This->e33) * InvDeterminant;
+	float e13 = (This->e12 * This->e23 - This->e13 * This->e22) * InvDeterminant;
+	float e21 = Cofactor12 * InvDeterminant;
+	float e22 = (This->e11 * This->e33 - This->e13 * This->e31) * InvDeterminant;
+	float e23 = (This->e13 * This->e21 - This->e11 * This->e23) * InvDeterminant;
+	float e31 = Cofactor13 * InvDeterminant;
+	float e32 = (This->e12 * This->e31 - This->e11 * This->e32) * InvDeterminant;
+	float e33 = (This->e11 * This->e22 - This->e12 * This->e21) * InvDeterminant;
+	
+	float Tx = This->e14;
+	float Ty = This->e24;
+	float Tz = This->e34;
+	
+	Mat44f_SetLine1(Inverse, e11, e12, e13, -(e11 * Tx + e12 * Ty + e13 * Tz));
+	Mat44f_SetLine2(Inverse, e21, e22, e23, -(e21 * Tx + e22 * Ty + e23 * Tz));
+	Mat44f_SetLine3(Inverse, e31, e32, e33, -(e31 * Tx + e32 * Ty + e33 * Tz));
+	Mat44f_SetLine4(Inverse, 0.0f, 0.0f, 0.0f, 1.0f);
+	
+	return 1;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Rotation and translation only, no scale : the inverse of
+// [R t ; 0 1] is [R^T -R^T t ; 0 1]. Nothing is checked.
+
+void Mat44f_InverseRigid(Mat44f* This, Mat44f* Inverse)
+{
+	float Tx = This->e14;
+	float Ty = This->e24;
+	float Tz = This->e34;
+	
+	Mat44f Rotation = *This;
+	
+	Mat44f_SetLine1(Inverse, Rotation.e11, Rotation.e21, Rotation.e31, -(Rotation.e11 * Tx + Rotation.e21 * Ty + Rotation.e31 * Tz));
+	Mat44f_SetLine2(Inverse, Rotation.e12, Rotation.e22, Rotation.e32, -(Rotation.e12 * Tx + Rotation.e22 * Ty + Rotation.e32 * Tz));
+	Mat44f_SetLine3(Inverse, Rotation.e13, Rotation.e23, Rotation.e33, -(Rotation.e13 * Tx + Rotation.e23 * Ty + Rotation.e33 * Tz));
+	Mat44f_SetLine4(Inverse, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+
 void Mat44f_Translation(Mat44f* This, Vec3f* Vector)
 {
 	This->e11 = 1.0f;
@@ -485,6 +566,39 @@ void Mat44f_Perspective(Mat44f* This, float FOVY, float Aspect, float Near, floa
 	This->e44 = 0.0f;
 }
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Inverse of Mat44f_Perspective() with the same parameters,
+// in closed form : x / Sx, y / Sy, z = -w and
+// w = (z + Sz w) / Pz.
+
+void Mat44f_InversePerspective(Mat44f* This, float FOVY, float Aspect, float Near, float Far)
+{
+	float Sy = 1.0f / tanf(FOVY/2.0f);
+	float Sx = Sy / Aspect;
+	float Sz = (Far + Near) / (Near - Far);
+	float Pz = (2.0f * Far * Near) / (Near - Far);
+	
+	This->e11 = 1.0f / Sx;
+	This->e21 = 0.0f;
+	This->e31 = 0.0f;
+	This->e41 = 0.0f;
+	
+	This->e12 = 0.0f;
+	This->e22 = 1.0f / Sy;
+	This->e32 = 0.0f;
+	This->e42 = 0.0f;
+	
+	This->e13 = 0.0f;
+	This->e23 = 0.0f;
+	This->e33 = 0.0f;
+	This->e43 = 1.0f / Pz;
+	
+	This->e14 = 0.0f;
+	This->e24 = 0.0f;
+	This->e34 = -1.0f;
+	This->e44 = Sz / Pz;
+}
+
 void Mat44f_Orthogonal(Mat44f* This, float Left, float Right, float Bottom, float Top, float Near, float Far)
 {
 	This->e11 = 2.0f / (Right - Left);
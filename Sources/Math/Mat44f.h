@@ -82,6 +82,8 @@ void Mat44f_Transpose(Mat44f* This);
 void Mat44f_Identity(Mat44f* This);
 float Mat44f_Determinant(Mat44f* This);
 int Mat44f_Inverse(Mat44f* This, Mat44f* Inverse);
+int Mat44f_InverseAffine(Mat44f* This, Mat44f* Inverse);
+void Mat44f_InverseRigid(Mat44f* This, Mat44f* Inverse);
 void Mat44f_Translation(Mat44f* This, Vec3f* Vector);
 void Mat44f_TranslationEx(Mat44f* This, float Tx, float Ty, float Tz);
 void Mat44f_Scale(Mat44f* This, Vec3f* Vector);
@@ -90,6 +92,7 @@ void Mat44f_RotateX(Mat44f* This, float Theta);
 void Mat44f_RotateY(Mat44f* This, float Theta);
 void Mat44f_RotateZ(Mat44f* This, float Theta);
 void Mat44f_Perspective(Mat44f* This, float FOVY, float Aspect, float Near, float Far);
+void Mat44f_InversePerspective(Mat44f* This, float FOVY, float Aspect, float Near, float Far);
 void Mat44f_Orthogonal(Mat44f* This, float Left, float Right, float Bottom, float Top, float Near, float Far);
 void Mat44f_ApplyTransformation(Mat44f* This, Vec3f* Vector, Vec3f* NewVector, int Mode);
 
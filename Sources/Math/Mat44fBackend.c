@@ -0,0 +1,745 @@
+/*
+ * Mat44fBackend.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include "Mat44fBackend.h"
+
+#if !defined(MAT_44F_SCALAR_ONLY) && (defined(__x86_64__) || defined(__i386__))
+	#define MAT_44F_X86
+	#include <immintrin.h>
+#endif
+
+#if !defined(MAT_44F_SCALAR_ONLY) && defined(__ARM_NEON)
+	#define MAT_44F_NEON
+	#include <arm_neon.h>
+#endif
+
+// The kernels see a Mat44f as 4 columns of 4 floats, see the
+// notes in Mat44f.h. The structures are not aligned.
+
+_Static_assert(sizeof(Mat44f) == 16 * sizeof(float), "Mat44f must be 16 packed floats");
+_Static_assert(sizeof(Vec4f) == 4 * sizeof(float), "Vec4f must be 4 packed floats");
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Batch kernels, see Mat44fBatch for the threaded entry points.
+// The points have W = 1, and e14 * 1.0f is e14 exactly, so the
+// SIMD kernels below still match these bits.
+
+static void Mat44f_MultiplyArrayScalar(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f Result = *This;
+		
+		Mat44f_MultiplyScalar(&Result, &Others[Index]);
+		Results[Index] = Result;
+	}
+}
+
+static void Mat44f_TransformVectorsScalar(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count)
+{
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f_ProductMatrixVectorScalar(This, &Vectors[Index], &NewVectors[Index]);
+	}
+}
+
+static void Mat44f_TransformPointsScalar(Mat44f* This, Vec3f* Points, Vec3f* NewPoints, size_t Count)
+{
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		float X = Points[Index].X;
+		float Y = Points[Index].Y;
+		float Z = Points[Index].Z;
+		
+		NewPoints[Index].X = This->e11 * X + This->e12 * Y + This->e13 * Z + This->e14;
+		NewPoints[Index].Y = This->e21 * X + This->e22 * Y + This->e23 * Z + This->e24;
+		NewPoints[Index].Z = This->e31 * X + This->e32 * Y + This->e33 * Z + This->e34;
+	}
+}
+
+static void Mat44f_TransformPointsSoAScalar(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		float PointX = X[Index];
+		float PointY = Y[Index];
+		float PointZ = Z[Index];
+		
+		NewX[Index] = This->e11 * PointX + This->e12 * PointY + This->e13 * PointZ + This->e14;
+		NewY[Index] = This->e21 * PointX + This->e22 * PointY + This->e23 * PointZ + This->e24;
+		NewZ[Index] = This->e31 * PointX + This->e32 * PointY + This->e33 * PointZ + This->e34;
+		
+		if (NewW != NULL)
+		{
+			NewW[Index] = This->e41 * PointX + This->e42 * PointY + This->e43 * PointZ + This->e44;
+		}
+	}
+}
+
+#if defined(MAT_44F_X86)
+
+#define MAT_44F_SHUFFLE(A, B, X, Y, Z, W) _mm_shuffle_ps(A, B, _MM_SHUFFLE(W, Z, Y, X))
+#define MAT_44F_SWIZZLE(A, X, Y, Z, W) MAT_44F_SHUFFLE(A, A, X, Y, Z, W)
+#define MAT_44F_SPLAT(A, X) MAT_44F_SHUFFLE(A, A, X, X, X, X)
+
+// Columns * B into Result, B is read before anything is stored.
+
+__attribute__((target("sse2")))
+static inline void Mat44f_MultiplyColumnsSSE(const __m128 Columns[4], float* B, float* Result)
+{
+	__m128 Product[4];
+	
+	for (int Index = 0; Index < 4; Index++)
+	{
+		__m128 Right = _mm_loadu_ps(B + 4 * Index);
+		
+		Product[Index] = _mm_mul_ps(Columns[0], MAT_44F_SPLAT(Right, 0));
+		Product[Index] = _mm_add_ps(Product[Index], _mm_mul_ps(Columns[1], MAT_44F_SPLAT(Right, 1)));
+		Product[Index] = _mm_add_ps(Product[Index], _mm_mul_ps(Columns[2], MAT_44F_SPLAT(Right, 2)));
+		Product[Index] = _mm_add_ps(Product[Index], _mm_mul_ps(Columns[3], MAT_44F_SPLAT(Right, 3)));
+	}
+	
+	_mm_storeu_ps(Result, Product[0]);
+	_mm_storeu_ps(Result + 4, Product[1]);
+	_mm_storeu_ps(Result + 8, Product[2]);
+	_mm_storeu_ps(Result + 12, Product[3]);
+}
+
+__attribute__((target("sse2")))
+static void Mat44f_MultiplySSE(Mat44f* This, Mat44f* Other)
+{
+	float* A = (float*)This;
+	__m128 Columns[4] = {_mm_loadu_ps(A), _mm_loadu_ps(A + 4), _mm_loadu_ps(A + 8), _mm_loadu_ps(A + 12)};
+	
+	Mat44f_MultiplyColumnsSSE(Columns, (float*)Other, A);
+}
+
+__attribute__((target("sse2")))
+static void Mat44f_MultiplyArraySSE(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	float* A = (float*)This;
+	__m128 Columns[4] = {_mm_loadu_ps(A), _mm_loadu_ps(A + 4), _mm_loadu_ps(A + 8), _mm_loadu_ps(A + 12)};
+	
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f_MultiplyColumnsSSE(Columns, (float*)&Others[Index], (float*)&Results[Index]);
+	}
+}
+
+__attribute__((target("sse2")))
+static void Mat44f_ProductMatrixVectorSSE(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
+{
+	float* A = (float*)This;
+	__m128 V = _mm_loadu_ps((float*)Vector);
+	
+	__m128 Result = _mm_mul_ps(_mm_loadu_ps(A), MAT_44F_SPLAT(V, 0));
+	Result = _mm_add_ps(Result, _mm_mul_ps(_mm_loadu_ps(A + 4), MAT_44F_SPLAT(V, 1)));
+	Result = _mm_add_ps(Result, _mm_mul_ps(_mm_loadu_ps(A + 8), MAT_44F_SPLAT(V, 2)));
+	Result = _mm_add_ps(Result, _mm_mul_ps(_mm_loadu_ps(A + 12), MAT_44F_SPLAT(V, 3)));
+	
+	_mm_storeu_ps((float*)NewVector, Result);
+}
+
+__attribute__((target("sse2")))
+static void Mat44f_TransformVectorsSSE(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count)
+{
+	float* A = (float*)This;
+	__m128 Column0 = _mm_loadu_ps(A);
+	__m128 Column1 = _mm_loadu_ps(A + 4);
+	__m128 Column2 = _mm_loadu_ps(A + 8);
+	__m128 Column3 = _mm_loadu_ps(A + 12);
+	
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		__m128 V = _mm_loadu_ps((float*)&Vectors[Index]);
+		
+		__m128 Result = _mm_mul_ps(Column0, MAT_44F_SPLAT(V, 0));
+		Result = _mm_add_ps(Result, _mm_mul_ps(Column1, MAT_44F_SPLAT(V, 1)));
+		Result = _mm_add_ps(Result, _mm_mul_ps(Column2, MAT_44F_SPLAT(V, 2)));
+		Result = _mm_add_ps(Result, _mm_mul_ps(Column3, MAT_44F_SPLAT(V, 3)));
+		
+		_mm_storeu_ps((float*)&NewVectors[Index], Result);
+	}
+}
+
+// A Vec3f is 12 bytes, the loads and stores stay inside each
+// point so the last one never touches past the array.
+
+__attribute__((target("sse2")))
+static void Mat44f_TransformPointsSSE(Mat44f* This, Vec3f* Points, Vec3f* NewPoints, size_t Count)
+{
+	float* A = (float*)This;
+	__m128 Column0 = _mm_loadu_ps(A);
+	__m128 Column1 = _mm_loadu_ps(A + 4);
+	__m128 Column2 = _mm_loadu_ps(A + 8);
+	__m128 Column3 = _mm_loadu_ps(A + 12);
+	
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		__m128 Result = _mm_mul_ps(Column0, _mm_set1_ps(Points[Index].X));
+		Result = _mm_add_ps(Result, _mm_mul_ps(Column1, _mm_set1_ps(Points[Index].Y)));
+		Result = _mm_add_ps(Result, _mm_mul_ps(Column2, _mm_set1_ps(Points[Index].Z)));
+		Result = _mm_add_ps(Result, Column3);
+		
+		_mm_storel_pi((__m64*)&NewPoints[Index].X, Result);
+		_mm_store_ss(&NewPoints[Index].Z, _mm_movehl_ps(Result, Result));
+	}
+}
+
+// Four points per iteration, one matrix element per register.
+
+__attribute__((target("sse2")))
+static void Mat44f_TransformPointsSoASSE(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	float* A = (float*)This;
+	__m128 Elements[16];
+	size_t Index = 0;
+	
+	for (int Element = 0; Element < 16; Element++)
+	{
+		Elements[Element] = _mm_set1_ps(A[Element]);
+	}
+	
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		__m128 PointX = _mm_loadu_ps(X + Index);
+		__m128 PointY = _mm_loadu_ps(Y + Index);
+		__m128 PointZ = _mm_loadu_ps(Z + Index);
+		
+		for (int Row = 0; Row < 4; Row++)
+		{
+			float* Output = Row == 0 ? NewX : Row == 1 ? NewY : Row == 2 ? NewZ : NewW;
+			
+			if (Output == NULL)
+			{
+				continue;
+			}
+			
+			__m128 Result = _mm_mul_ps(Elements[Row], PointX);
+			Result = _mm_add_ps(Result, _mm_mul_ps(Elements[4 + Row], PointY));
+			Result = _mm_add_ps(Result, _mm_mul_ps(Elements[8 + Row], PointZ));
+			Result = _mm_add_ps(Result, Elements[12 + Row]);
+			
+			_mm_storeu_ps(Output + Index, Result);
+		}
+	}
+	
+	Mat44f_TransformPointsSoAScalar(This, X + Index, Y + Index, Z + Index, NewX + Index, NewY + Index, NewZ + Index, NewW != NULL ? NewW + Index : NULL, Count - Index);
+}
+
+__attribute__((target("sse2")))
+static void Mat44f_TransposeSSE(Mat44f* This)
+{
+	float* A = (float*)This;
+	
+	__m128 Column0 = _mm_loadu_ps(A);
+	__m128 Column1 = _mm_loadu_ps(A + 4);
+	__m128 Column2 = _mm_loadu_ps(A + 8);
+	__m128 Column3 = _mm_loadu_ps(A + 12);
+	
+	_MM_TRANSPOSE4_PS(Column0, Column1, Column2, Column3);
+	
+	_mm_storeu_ps(A, Column0);
+	_mm_storeu_ps(A + 4, Column1);
+	_mm_storeu_ps(A + 8, Column2);
+	_mm_storeu_ps(A + 12, Column3);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// 2x2 blocks stored as (m11, m12, m21, m22) : A * B, A# * B
+// and A * B#, where # is the adjugate.
+
+__attribute__((target("sse2")))
+static inline __m128 Mat44f_Mat22Multiply(__m128 A, __m128 B)
+{
+	return _mm_add_ps(_mm_mul_ps(A, MAT_44F_SWIZZLE(B, 0, 3, 0, 3)), _mm_mul_ps(MAT_44F_SWIZZLE(A, 1, 0, 3, 2), MAT_44F_SWIZZLE(B, 2, 1, 2, 1)));
+}
+
+__attribute__((target("sse2")))
+static inline __m128 Mat44f_Mat22AdjugateMultiply(__m128 A, __m128 B)
+{
+	return _mm_sub_ps(_mm_mul_ps(MAT_44F_SWIZZLE(A, 3, 3, 0, 0), B), _mm_mul_ps(MAT_44F_SWIZZLE(A, 1, 1, 2, 2), MAT_44F_SWIZZLE(B, 2, 3, 0, 1)));
+}
+
+__attribute__((target("sse2")))
+static inline __m128 Mat44f_Mat22MultiplyAdjugate(__m128 A, __m128 B)
+{
+	return _mm_sub_ps(_mm_mul_ps(A, MAT_44F_SWIZZLE(B, 3, 0, 3, 0)), _mm_mul_ps(MAT_44F_SWIZZLE(A, 1, 0, 3, 2), MAT_44F_SWIZZLE(B, 2, 1, 2, 1)));
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Block-wise inverse, M = [A B ; C D] with 2x2 blocks. It is
+// written for rows, the columns loaded here are the rows of
+// the transpose and inv(M^T)^T = inv(M), so the stores need
+// no extra shuffle. Same singular test as the scalar code.
+
+__attribute__((target("sse2")))
+static int Mat44f_InverseSSE(Mat44f* This, Mat44f* Inverse)
+{
+	float* M = (float*)This;
+	
+	__m128 Row0 = _mm_loadu_ps(M);
+	__m128 Row1 = _mm_loadu_ps(M + 4);
+	__m128 Row2 = _mm_loadu_ps(M + 8);
+	__m128 Row3 = _mm_loadu_ps(M + 12);
+	
+	__m128 A = _mm_movelh_ps(Row0, Row1);
+	__m128 B = _mm_movehl_ps(Row1, Row0);
+	__m128 C = _mm_movelh_ps(Row2, Row3);
+	__m128 D = _mm_movehl_ps(Row3, Row2);
+	
+	// (|A|, |B|, |C|, |D|)
+	
+	__m128 SubDeterminants = _mm_sub_ps(
+		_mm_mul_ps(MAT_44F_SHUFFLE(Row0, Row2, 0, 2, 0, 2), MAT_44F_SHUFFLE(Row1, Row3, 1, 3, 1, 3)),
+		_mm_mul_ps(MAT_44F_SHUFFLE(Row0, Row2, 1, 3, 1, 3), MAT_44F_SHUFFLE(Row1, Row3, 0, 2, 0, 2)));
+	
+	__m128 DetA = MAT_44F_SPLAT(SubDeterminants, 0);
+	__m128 DetB = MAT_44F_SPLAT(SubDeterminants, 1);
+	__m128 DetC = MAT_44F_SPLAT(SubDeterminants, 2);
+	__m128 DetD = MAT_44F_SPLAT(SubDeterminants, 3);
+	
+	__m128 AdjD_C = Mat44f_Mat22AdjugateMultiply(D, C);
+	__m128 AdjA_B = Mat44f_Mat22AdjugateMultiply(A, B);
+	
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	
+	__m128 Trace = _mm_mul_ps(AdjA_B, MAT_44F_SWIZZLE(AdjD_C, 0, 2, 1, 3));
+	Trace = _mm_add_ps(Trace, MAT_44F_SWIZZLE(Trace, 1, 0, 3, 2));
+	Trace = _mm_add_ps(Trace, _mm_movehl_ps(Trace, Trace));
+	
+	__m128 Determinant = _mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC));
+	Determinant = MAT_44F_SPLAT(_mm_sub_ps(Determinant, Trace), 0);
+	
+	if (fabsf(_mm_cvtss_f32(Determinant)) <= 0.00001f)
+	{
+		Mat44f_Identity(Inverse);
+		return 0;
+	}
+	
+	// Adjugates of the blocks of |M| inv(M) = [X Y ; Z W].
+	
+	__m128 AdjX = _mm_sub_ps(_mm_mul_ps(DetD, A), Mat44f_Mat22Multiply(B, AdjD_C));
+	__m128 AdjW = _mm_sub_ps(_mm_mul_ps(DetA, D), Mat44f_Mat22Multiply(C, AdjA_B));
+	__m128 AdjY = _mm_sub_ps(_mm_mul_ps(DetB, C), Mat44f_Mat22MultiplyAdjugate(D, AdjA_B));
+	__m128 AdjZ = _mm_sub_ps(_mm_mul_ps(DetC, B), Mat44f_Mat22MultiplyAdjugate(A, AdjD_C));
+	
+	__m128 InvDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), Determinant);
+	
+	AdjX = _mm_mul_ps(AdjX, InvDeterminant);
+	AdjY = _mm_mul_ps(AdjY, InvDeterminant);
+	AdjZ = _mm_mul_ps(AdjZ, InvDeterminant);
+	AdjW = _mm_mul_ps(AdjW, InvDeterminant);
+	
+	// The adjugate of each block is taken by the store shuffles.
+	
+	float* Result = (float*)Inverse;
+	
+	_mm_storeu_ps(Result, MAT_44F_SHUFFLE(AdjX, AdjY, 3, 1, 3, 1));
+	_mm_storeu_ps(Result + 4, MAT_44F_SHUFFLE(AdjX, AdjY, 2, 0, 2, 0));
+	_mm_storeu_ps(Result + 8, MAT_44F_SHUFFLE(AdjZ, AdjW, 3, 1, 3, 1));
+	_mm_storeu_ps(Result + 12, MAT_44F_SHUFFLE(AdjZ, AdjW, 2, 0, 2, 0));
+	
+	return 1;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Two result columns per iteration : each column of This is
+// repeated in both lanes and the permute spreads one element
+// of two columns of Other. Same additions as the scalar code,
+// no FMA. The other kernels are the SSE ones, the compiler
+// puts a vzeroupper before leaving.
+
+__attribute__((target("avx")))
+static inline void Mat44f_LoadColumnsAVX(float* A, __m256 Columns[4])
+{
+	for (int Index = 0; Index < 4; Index++)
+	{
+		__m128 Column = _mm_loadu_ps(A + 4 * Index);
+		Columns[Index] = _mm256_insertf128_ps(_mm256_castps128_ps256(Column), Column, 1);
+	}
+}
+
+__attribute__((target("avx")))
+static inline void Mat44f_MultiplyColumnsAVX(const __m256 Columns[4], float* B, float* Result)
+{
+	__m256 Right01 = _mm256_loadu_ps(B);
+	__m256 Right23 = _mm256_loadu_ps(B + 8);
+	
+	__m256 Result01 = _mm256_mul_ps(Columns[0], _mm256_permute_ps(Right01, 0x00));
+	__m256 Result23 = _mm256_mul_ps(Columns[0], _mm256_permute_ps(Right23, 0x00));
+	
+	Result01 = _mm256_add_ps(Result01, _mm256_mul_ps(Columns[1], _mm256_permute_ps(Right01, 0x55)));
+	Result23 = _mm256_add_ps(Result23, _mm256_mul_ps(Columns[1], _mm256_permute_ps(Right23, 0x55)));
+	
+	Result01 = _mm256_add_ps(Result01, _mm256_mul_ps(Columns[2], _mm256_permute_ps(Right01, 0xAA)));
+	Result23 = _mm256_add_ps(Result23, _mm256_mul_ps(Columns[2], _mm256_permute_ps(Right23, 0xAA)));
+	
+	Result01 = _mm256_add_ps(Result01, _mm256_mul_ps(Columns[3], _mm256_permute_ps(Right01, 0xFF)));
+	Result23 = _mm256_add_ps(Result23, _mm256_mul_ps(Columns[3], _mm256_permute_ps(Right23, 0xFF)));
+	
+	_mm256_storeu_ps(Result, Result01);
+	_mm256_storeu_ps(Result + 8, Result23);
+}
+
+__attribute__((target("avx")))
+static void Mat44f_MultiplyAVX(Mat44f* This, Mat44f* Other)
+{
+	__m256 Columns[4];
+	
+	Mat44f_LoadColumnsAVX((float*)This, Columns);
+	Mat44f_MultiplyColumnsAVX(Columns, (float*)Other, (float*)This);
+}
+
+__attribute__((target("avx")))
+static void Mat44f_MultiplyArrayAVX(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	__m256 Columns[4];
+	
+	Mat44f_LoadColumnsAVX((float*)This, Columns);
+	
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f_MultiplyColumnsAVX(Columns, (float*)&Others[Index], (float*)&Results[Index]);
+	}
+}
+
+__attribute__((target("avx")))
+static void Mat44f_TransformPointsSoAAVX(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	float* A = (float*)This;
+	__m256 Elements[16];
+	size_t Index = 0;
+	
+	for (int Element = 0; Element < 16; Element++)
+	{
+		Elements[Element] = _mm256_set1_ps(A[Element]);
+	}
+	
+	for (; Index + 8 <= Count; Index += 8)
+	{
+		__m256 PointX = _mm256_loadu_ps(X + Index);
+		__m256 PointY = _mm256_loadu_ps(Y + Index);
+		__m256 PointZ = _mm256_loadu_ps(Z + Index);
+		
+		for (int Row = 0; Row < 4; Row++)
+		{
+			float* Output = Row == 0 ? NewX : Row == 1 ? NewY : Row == 2 ? NewZ : NewW;
+			
+			if (Output == NULL)
+			{
+				continue;
+			}
+			
+			__m256 Result = _mm256_mul_ps(Elements[Row], PointX);
+			Result = _mm256_add_ps(Result, _mm256_mul_ps(Elements[4 + Row], PointY));
+			Result = _mm256_add_ps(Result, _mm256_mul_ps(Elements[8 + Row], PointZ));
+			Result = _mm256_add_ps(Result, Elements[12 + Row]);
+			
+			_mm256_storeu_ps(Output + Index, Result);
+		}
+	}
+	
+	Mat44f_TransformPointsSoAScalar(This, X + Index, Y + Index, Z + Index, NewX + Index, NewY + Index, NewZ + Index, NewW != NULL ? NewW + Index : NULL, Count - Index);
+}
+
+#endif
+
+#if defined(MAT_44F_NEON)
+
+static inline void Mat44f_MultiplyColumnsNEON(const float32x4_t Columns[4], float* B, float* Result)
+{
+	float32x4_t Product[4];
+	
+	for (int Index = 0; Index < 4; Index++)
+	{
+		float32x4_t Right = vld1q_f32(B + 4 * Index);
+		
+		Product[Index] = vmulq_n_f32(Columns[0], vgetq_lane_f32(Right, 0));
+		Product[Index] = vaddq_f32(Product[Index], vmulq_n_f32(Columns[1], vgetq_lane_f32(Right, 1)));
+		Product[Index] = vaddq_f32(Product[Index], vmulq_n_f32(Columns[2], vgetq_lane_f32(Right, 2)));
+		Product[Index] = vaddq_f32(Product[Index], vmulq_n_f32(Columns[3], vgetq_lane_f32(Right, 3)));
+	}
+	
+	vst1q_f32(Result, Product[0]);
+	vst1q_f32(Result + 4, Product[1]);
+	vst1q_f32(Result + 8, Product[2]);
+	vst1q_f32(Result + 12, Product[3]);
+}
+
+static void Mat44f_MultiplyNEON(Mat44f* This, Mat44f* Other)
+{
+	float* A = (float*)This;
+	float32x4_t Columns[4] = {vld1q_f32(A), vld1q_f32(A + 4), vld1q_f32(A + 8), vld1q_f32(A + 12)};
+	
+	Mat44f_MultiplyColumnsNEON(Columns, (float*)Other, A);
+}
+
+static void Mat44f_MultiplyArrayNEON(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	float* A = (float*)This;
+	float32x4_t Columns[4] = {vld1q_f32(A), vld1q_f32(A + 4), vld1q_f32(A + 8), vld1q_f32(A + 12)};
+	
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f_MultiplyColumnsNEON(Columns, (float*)&Others[Index], (float*)&Results[Index]);
+	}
+}
+
+static void Mat44f_TransformPointsSoANEON(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	float* A = (float*)This;
+	size_t Index = 0;
+	
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		float32x4_t PointX = vld1q_f32(X + Index);
+		float32x4_t PointY = vld1q_f32(Y + Index);
+		float32x4_t PointZ = vld1q_f32(Z + Index);
+		
+		for (int Row = 0; Row < 4; Row++)
+		{
+			float* Output = Row == 0 ? NewX : Row == 1 ? NewY : Row == 2 ? NewZ : NewW;
+			
+			if (Output == NULL)
+			{
+				continue;
+			}
+			
+			float32x4_t Result = vmulq_n_f32(PointX, A[Row]);
+			Result = vaddq_f32(Result, vmulq_n_f32(PointY, A[4 + Row]));
+			Result = vaddq_f32(Result, vmulq_n_f32(PointZ, A[8 + Row]));
+			Result = vaddq_f32(Result, vdupq_n_f32(A[12 + Row]));
+			
+			vst1q_f32(Output + Index, Result);
+		}
+	}
+	
+	Mat44f_TransformPointsSoAScalar(This, X + Index, Y + Index, Z + Index, NewX + Index, NewY + Index, NewZ + Index, NewW != NULL ? NewW + Index : NULL, Count - Index);
+}
+
+static void Mat44f_ProductMatrixVectorNEON(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
+{
+	float* A = (float*)This;
+	float32x4_t V = vld1q_f32((float*)Vector);
+	
+	float32x4_t Result = vmulq_n_f32(vld1q_f32(A), vgetq_lane_f32(V, 0));
+	Result = vaddq_f32(Result, vmulq_n_f32(vld1q_f32(A + 4), vgetq_lane_f32(V, 1)));
+	Result = vaddq_f32(Result, vmulq_n_f32(vld1q_f32(A + 8), vgetq_lane_f32(V, 2)));
+	Result = vaddq_f32(Result, vmulq_n_f32(vld1q_f32(A + 12), vgetq_lane_f32(V, 3)));
+	
+	vst1q_f32((float*)NewVector, Result);
+}
+
+static void Mat44f_TransformVectorsNEON(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count)
+{
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		Mat44f_ProductMatrixVectorNEON(This, &Vectors[Index], &NewVectors[Index]);
+	}
+}
+
+static void Mat44f_TransposeNEON(Mat44f* This)
+{
+	float* A = (float*)This;
+	
+	// The de-interleaving load gives the rows.
+	
+	float32x4x4_t Rows = vld4q_f32(A);
+	
+	vst1q_f32(A, Rows.val[0]);
+	vst1q_f32(A + 4, Rows.val[1]);
+	vst1q_f32(A + 8, Rows.val[2]);
+	vst1q_f32(A + 12, Rows.val[3]);
+}
+
+#endif
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The backends not compiled in keep the scalar kernels, they
+// are never selected anyway, see IsSupported().
+
+static const Mat44fBackend Mat44fBackends[MAT_44F_BACKEND_MAX] =
+{
+	{"Scalar", Mat44f_MultiplyScalar, Mat44f_InverseScalar, Mat44f_TransposeScalar, Mat44f_ProductMatrixVectorScalar,
+		Mat44f_MultiplyArrayScalar, Mat44f_TransformVectorsScalar, Mat44f_TransformPointsScalar, Mat44f_TransformPointsSoAScalar},
+
+#if defined(MAT_44F_X86)
+	{"SSE", Mat44f_MultiplySSE, Mat44f_InverseSSE, Mat44f_TransposeSSE, Mat44f_ProductMatrixVectorSSE,
+		Mat44f_MultiplyArraySSE, Mat44f_TransformVectorsSSE, Mat44f_TransformPointsSSE, Mat44f_TransformPointsSoASSE},
+	{"AVX", Mat44f_MultiplyAVX, Mat44f_InverseSSE, Mat44f_TransposeSSE, Mat44f_ProductMatrixVectorSSE,
+		Mat44f_MultiplyArrayAVX, Mat44f_TransformVectorsSSE, Mat44f_TransformPointsSSE, Mat44f_TransformPointsSoAAVX},
+#else
+	{"SSE", Mat44f_MultiplyScalar, Mat44f_InverseScalar, Mat44f_TransposeScalar, Mat44f_ProductMatrixVectorScalar,
+		Mat44f_MultiplyArrayScalar, Mat44f_TransformVectorsScalar, Mat44f_TransformPointsScalar, Mat44f_TransformPointsSoAScalar},
+	{"AVX", Mat44f_MultiplyScalar, Mat44f_InverseScalar, Mat44f_TransposeScalar, Mat44f_ProductMatrixVectorScalar,
+		Mat44f_MultiplyArrayScalar, Mat44f_TransformVectorsScalar, Mat44f_TransformPointsScalar, Mat44f_TransformPointsSoAScalar},
+#endif
+
+#if defined(MAT_44F_NEON)
+	{"NEON", Mat44f_MultiplyNEON, Mat44f_InverseScalar, Mat44f_TransposeNEON, Mat44f_ProductMatrixVectorNEON,
+		Mat44f_MultiplyArrayNEON, Mat44f_TransformVectorsNEON, Mat44f_TransformPointsScalar, Mat44f_TransformPointsSoANEON}
+#else
+	{"NEON", Mat44f_MultiplyScalar, Mat44f_InverseScalar, Mat44f_TransposeScalar, Mat44f_ProductMatrixVectorScalar,
+		Mat44f_MultiplyArrayScalar, Mat44f_TransformVectorsScalar, Mat44f_TransformPointsScalar, Mat44f_TransformPointsSoAScalar}
+#endif
+};
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Until a backend is selected, Mat44f_Backend points to these
+// kernels. The first call picks the best backend and forwards.
+
+static void Mat44fBackend_ResolveMultiply(Mat44f* This, Mat44f* Other)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->Multiply(This, Other);
+}
+
+static int Mat44fBackend_ResolveInverse(Mat44f* This, Mat44f* Inverse)
+{
+	Mat44fBackend_SelectBest();
+	return Mat44f_Backend->Inverse(This, Inverse);
+}
+
+static void Mat44fBackend_ResolveTranspose(Mat44f* This)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->Transpose(This);
+}
+
+static void Mat44fBackend_ResolveProductMatrixVector(Mat44f* This, Vec4f* Vector, Vec4f* NewVector)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->ProductMatrixVector(This, Vector, NewVector);
+}
+
+static void Mat44fBackend_ResolveMultiplyArray(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->MultiplyArray(This, Others, Results, Count);
+}
+
+static void Mat44fBackend_ResolveTransformVectors(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->TransformVectors(This, Vectors, NewVectors, Count);
+}
+
+static void Mat44fBackend_ResolveTransformPoints(Mat44f* This, Vec3f* Points, Vec3f* NewPoints, size_t Count)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->TransformPoints(This, Points, NewPoints, Count);
+}
+
+static void Mat44fBackend_ResolveTransformPointsSoA(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	Mat44fBackend_SelectBest();
+	Mat44f_Backend->TransformPointsSoA(This, X, Y, Z, NewX, NewY, NewZ, NewW, Count);
+}
+
+static const Mat44fBackend Mat44fBackendResolver =
+{
+	"Unresolved", Mat44fBackend_ResolveMultiply, Mat44fBackend_ResolveInverse, Mat44fBackend_ResolveTranspose, Mat44fBackend_ResolveProductMatrixVector,
+	Mat44fBackend_ResolveMultiplyArray, Mat44fBackend_ResolveTransformVectors, Mat44fBackend_ResolveTransformPoints, Mat44fBackend_ResolveTransformPointsSoA
+};
+
+const Mat44fBackend* Mat44f_Backend = &Mat44fBackendResolver;
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// __builtin_cpu_supports() reads CPUID, and for AVX also
+// checks that the OS saves the YMM registers (XGETBV).
+
+int Mat44fBackend_IsSupported(int BackendID)
+{
+	switch (BackendID)
+	{
+		case MAT_44F_BACKEND_SCALAR:
+			return 1;
+
+#if defined(MAT_44F_X86)
+		case MAT_44F_BACKEND_SSE:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse2") != 0;
+		
+		case MAT_44F_BACKEND_AVX:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx") != 0;
+#endif
+
+#if defined(MAT_44F_NEON)
+		case MAT_44F_BACKEND_NEON:
+			return 1;
+#endif
+		
+		default:
+			return 0;
+	}
+}
+
+int Mat44fBackend_Select(int BackendID)
+{
+	if (BackendID < 0 || BackendID >= MAT_44F_BACKEND_MAX || !Mat44fBackend_IsSupported(BackendID))
+	{
+		return 0;
+	}
+	
+	Mat44f_Backend = &Mat44fBackends[BackendID];
+	
+	return 1;
+}
+
+int Mat44fBackend_SelectBest(void)
+{
+	for (int BackendID = MAT_44F_BACKEND_MAX - 1; BackendID > MAT_44F_BACKEND_SCALAR; BackendID--)
+	{
+		if (Mat44fBackend_Select(BackendID))
+		{
+			return BackendID;
+		}
+	}
+	
+	Mat44fBackend_Select(MAT_44F_BACKEND_SCALAR);
+	
+	return MAT_44F_BACKEND_SCALAR;
+}
+
+// The batch jobs resolve the backend on the calling thread
+// before the workers read it.
+
+const Mat44fBackend* Mat44fBackend_Get(void)
+{
+	if (Mat44f_Backend == &Mat44fBackendResolver)
+	{
+		Mat44fBackend_SelectBest();
+	}
+	
+	return Mat44f_Backend;
+}
+
+const char* Mat44fBackend_GetName(void)
+{
+	return Mat44f_Backend->Name;
+}
@@ -0,0 +1,96 @@
+/*
+ * Mat44fBackend.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef MAT_44F_BACKEND_H
+#define MAT_44F_BACKEND_H
+
+#include <stddef.h>
+
+#include "Mat44f.h"
+
+/* <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+ * Notes : Mat44fBackend
+ * 
+ * Mat44f_Multiply(), Mat44f_Inverse(), Mat44f_Transpose()
+ * et Mat44f_ProductMatrixVector() passent par le backend
+ * courant. Au premier appel, le meilleur backend que le
+ * processeur supporte est choisi avec CPUID :
+ * 
+ * AVX  --> 2 colonnes du produit par instruction
+ * SSE  --> 1 colonne par instruction, inverse par blocs 2x2
+ * NEON --> produit, transposée et vecteur (ARM)
+ * 
+ * Le produit, la transposée et le vecteur donnent les mêmes
+ * bits que le code scalaire (même ordre des additions).
+ * L'inverse par blocs diffère du cofacteur à la précision
+ * du float près.
+ * 
+ * Les kernels par lot (MultiplyArray, TransformVectors,
+ * TransformPoints et TransformPointsSoA) sont appelés par
+ * Mat44fBatch.
+ * 
+ * Compiler avec -DMAT_44F_SCALAR_ONLY pour forcer le code
+ * scalaire.
+ * 
+ */
+
+enum Mat44fBackendID
+{
+	MAT_44F_BACKEND_SCALAR,
+	MAT_44F_BACKEND_SSE,
+	MAT_44F_BACKEND_AVX,
+	MAT_44F_BACKEND_NEON,
+	MAT_44F_BACKEND_MAX
+};
+
+typedef struct Mat44fBackend Mat44fBackend;
+
+struct Mat44fBackend
+{
+	const char* Name;
+	
+	void (*Multiply)(Mat44f*, Mat44f*);
+	int (*Inverse)(Mat44f*, Mat44f*);
+	void (*Transpose)(Mat44f*);
+	void (*ProductMatrixVector)(Mat44f*, Vec4f*, Vec4f*);
+	
+	void (*MultiplyArray)(Mat44f*, Mat44f*, Mat44f*, size_t);
+	void (*TransformVectors)(Mat44f*, Vec4f*, Vec4f*, size_t);
+	void (*TransformPoints)(Mat44f*, Vec3f*, Vec3f*, size_t);
+	void (*TransformPointsSoA)(Mat44f*, const float*, const float*, const float*, float*, float*, float*, float*, size_t);
+};
+
+extern const Mat44fBackend* Mat44f_Backend;
+
+int Mat44fBackend_IsSupported(int BackendID);
+int Mat44fBackend_Select(int BackendID);
+int Mat44fBackend_SelectBest(void);
+const Mat44fBackend* Mat44fBackend_Get(void);
+const char* Mat44fBackend_GetName(void);
+
+void Mat44f_MultiplyScalar(Mat44f* This, Mat44f* Other);
+int Mat44f_InverseScalar(Mat44f* This, Mat44f* Inverse);
+void Mat44f_TransposeScalar(Mat44f* This);
+void Mat44f_ProductMatrixVectorScalar(Mat44f* This, Vec4f* Vector, Vec4f* NewVector);
+
+#endif
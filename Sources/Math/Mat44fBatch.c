@@ -0,0 +1,289 @@
+/*
+ * Mat44fBatch.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "Mat44fBackend.h"
+#include "Mat44fBatch.h"
+
+typedef struct Mat44fBatchJob Mat44fBatchJob;
+
+struct Mat44fBatchJob
+{
+	void (*Run)(Mat44fBatchJob*, size_t, size_t);
+	const Mat44fBackend* Backend;
+	Mat44f* Matrix;
+	void* Input;
+	void* Output;
+	const float* X;
+	const float* Y;
+	const float* Z;
+	float* NewX;
+	float* NewY;
+	float* NewZ;
+	float* NewW;
+};
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The workers sleep on Start between the batches. Each batch
+// bumps Generation, worker N runs chunk N + 1 while the caller
+// runs chunk 0, the last worker done signals Done. Lock keeps
+// one batch or one SetThreads() at a time.
+
+static struct
+{
+	pthread_mutex_t Lock;
+	pthread_mutex_t Mutex;
+	pthread_cond_t Start;
+	pthread_cond_t Done;
+	
+	pthread_t Workers[MAT_44F_BATCH_THREADS_MAX];
+	unsigned int WorkerGenerations[MAT_44F_BATCH_THREADS_MAX];
+	int WorkersCount;
+	int IsStopping;
+	
+	unsigned int Generation;
+	int Pending;
+	Mat44fBatchJob* Job;
+	size_t Count;
+	int Chunks;
+
+} Mat44fBatchPool = {.Lock = PTHREAD_MUTEX_INITIALIZER, .Mutex = PTHREAD_MUTEX_INITIALIZER, .Start = PTHREAD_COND_INITIALIZER, .Done = PTHREAD_COND_INITIALIZER};
+
+// The chunks start on multiples of 8 elements, a whole AVX
+// iteration, so the split never changes which kernel path
+// handles an element.
+
+static void Mat44fBatch_RunChunk(int Chunk)
+{
+	size_t Count = Mat44fBatchPool.Count;
+	size_t Chunks = (size_t) Mat44fBatchPool.Chunks;
+	size_t Begin = (Count * Chunk / Chunks) & ~(size_t) 7;
+	size_t End = Chunk + 1 == (int) Chunks ? Count : (Count * (Chunk + 1) / Chunks) & ~(size_t) 7;
+	
+	if (Begin < End)
+	{
+		Mat44fBatchPool.Job->Run(Mat44fBatchPool.Job, Begin, End);
+	}
+}
+
+static void* Mat44fBatch_Worker(void* Data)
+{
+	int WorkerID = (int) (intptr_t) Data;
+	unsigned int* Generation = &Mat44fBatchPool.WorkerGenerations[WorkerID];
+	
+	pthread_mutex_lock(&Mat44fBatchPool.Mutex);
+	
+	while (1)
+	{
+		while (*Generation == Mat44fBatchPool.Generation && !Mat44fBatchPool.IsStopping)
+		{
+			pthread_cond_wait(&Mat44fBatchPool.Start, &Mat44fBatchPool.Mutex);
+		}
+		
+		if (Mat44fBatchPool.IsStopping)
+		{
+			break;
+		}
+		
+		*Generation = Mat44fBatchPool.Generation;
+		pthread_mutex_unlock(&Mat44fBatchPool.Mutex);
+		
+		Mat44fBatch_RunChunk(WorkerID + 1);
+		
+		pthread_mutex_lock(&Mat44fBatchPool.Mutex);
+		
+		if (--Mat44fBatchPool.Pending == 0)
+		{
+			pthread_cond_signal(&Mat44fBatchPool.Done);
+		}
+	}
+	
+	pthread_mutex_unlock(&Mat44fBatchPool.Mutex);
+	
+	return NULL;
+}
+
+static void Mat44fBatch_StopWorkers(void)
+{
+	pthread_mutex_lock(&Mat44fBatchPool.Mutex);
+	Mat44fBatchPool.IsStopping = 1;
+	pthread_cond_broadcast(&Mat44fBatchPool.Start);
+	pthread_mutex_unlock(&Mat44fBatchPool.Mutex);
+	
+	for (int WorkerID = 0; WorkerID < Mat44fBatchPool.WorkersCount; WorkerID++)
+	{
+		pthread_join(Mat44fBatchPool.Workers[WorkerID], NULL);
+	}
+	
+	Mat44fBatchPool.WorkersCount = 0;
+	Mat44fBatchPool.IsStopping = 0;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// ThreadsCount counts the calling thread, 0 or 1 stops the
+// workers. Returns the count really running, it is lower if
+// a thread could not be created.
+
+int Mat44fBatch_SetThreads(int ThreadsCount)
+{
+	if (ThreadsCount > MAT_44F_BATCH_THREADS_MAX)
+	{
+		ThreadsCount = MAT_44F_BATCH_THREADS_MAX;
+	}
+	
+	pthread_mutex_lock(&Mat44fBatchPool.Lock);
+	
+	Mat44fBatch_StopWorkers();
+	
+	for (int WorkerID = 0; WorkerID < ThreadsCount - 1; WorkerID++)
+	{
+		Mat44fBatchPool.WorkerGenerations[WorkerID] = Mat44fBatchPool.Generation;
+		
+		if (pthread_create(&Mat44fBatchPool.Workers[WorkerID], NULL, Mat44fBatch_Worker, (void*) (intptr_t) WorkerID) != 0)
+		{
+			break;
+		}
+		
+		Mat44fBatchPool.WorkersCount++;
+	}
+	
+	int Result = Mat44fBatchPool.WorkersCount + 1;
+	
+	pthread_mutex_unlock(&Mat44fBatchPool.Lock);
+	
+	return Result;
+}
+
+int Mat44fBatch_GetThreads(void)
+{
+	return Mat44fBatchPool.WorkersCount + 1;
+}
+
+static void Mat44fBatch_Run(Mat44fBatchJob* Job, size_t Count)
+{
+	Job->Backend = Mat44fBackend_Get();
+	
+	if (Count < MAT_44F_BATCH_PARALLEL_MIN)
+	{
+		Job->Run(Job, 0, Count);
+		return;
+	}
+	
+	pthread_mutex_lock(&Mat44fBatchPool.Lock);
+	
+	if (Mat44fBatchPool.WorkersCount == 0)
+	{
+		Job->Run(Job, 0, Count);
+		pthread_mutex_unlock(&Mat44fBatchPool.Lock);
+		return;
+	}
+	
+	pthread_mutex_lock(&Mat44fBatchPool.Mutex);
+	Mat44fBatchPool.Job = Job;
+	Mat44fBatchPool.Count = Count;
+	Mat44fBatchPool.Chunks = Mat44fBatchPool.WorkersCount + 1;
+	Mat44fBatchPool.Pending = Mat44fBatchPool.WorkersCount;
+	Mat44fBatchPool.Generation++;
+	pthread_cond_broadcast(&Mat44fBatchPool.Start);
+	pthread_mutex_unlock(&Mat44fBatchPool.Mutex);
+	
+	Mat44fBatch_RunChunk(0);
+	
+	pthread_mutex_lock(&Mat44fBatchPool.Mutex);
+	
+	while (Mat44fBatchPool.Pending > 0)
+	{
+		pthread_cond_wait(&Mat44fBatchPool.Done, &Mat44fBatchPool.Mutex);
+	}
+	
+	pthread_mutex_unlock(&Mat44fBatchPool.Mutex);
+	pthread_mutex_unlock(&Mat44fBatchPool.Lock);
+}
+
+static void Mat44fBatch_RunMultiplyArray(Mat44fBatchJob* Job, size_t Begin, size_t End)
+{
+	Job->Backend->MultiplyArray(Job->Matrix, (Mat44f*) Job->Input + Begin, (Mat44f*) Job->Output + Begin, End - Begin);
+}
+
+static void Mat44fBatch_RunTransformVectors(Mat44fBatchJob* Job, size_t Begin, size_t End)
+{
+	Job->Backend->TransformVectors(Job->Matrix, (Vec4f*) Job->Input + Begin, (Vec4f*) Job->Output + Begin, End - Begin);
+}
+
+static void Mat44fBatch_RunTransformPoints(Mat44fBatchJob* Job, size_t Begin, size_t End)
+{
+	Job->Backend->TransformPoints(Job->Matrix, (Vec3f*) Job->Input + Begin, (Vec3f*) Job->Output + Begin, End - Begin);
+}
+
+static void Mat44fBatch_RunTransformPointsSoA(Mat44fBatchJob* Job, size_t Begin, size_t End)
+{
+	Job->Backend->TransformPointsSoA(Job->Matrix, Job->X + Begin, Job->Y + Begin, Job->Z + Begin, Job->NewX + Begin, Job->NewY + Begin, Job->NewZ + Begin, Job->NewW != NULL ? Job->NewW + Begin : NULL, End - Begin);
+}
+
+// Results[i] = This * Others[i]
+
+void Mat44fBatch_MultiplyArray(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count)
+{
+	Mat44fBatchJob Job = {.Run = Mat44fBatch_RunMultiplyArray, .Matrix = This, .Input = Others, .Output = Results};
+	
+	Mat44fBatch_Run(&Job, Count);
+}
+
+// Results[i] = Projection * View * Models[i], the projection
+// view product is done once.
+
+void Mat44fBatch_ModelViewProjection(Mat44f* Projection, Mat44f* View, Mat44f* Models, Mat44f* Results, size_t Count)
+{
+	Mat44f ProjectionView = *Projection;
+	
+	Mat44f_Multiply(&ProjectionView, View);
+	Mat44fBatch_MultiplyArray(&ProjectionView, Models, Results, Count);
+}
+
+void Mat44fBatch_TransformVectors(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count)
+{
+	Mat44fBatchJob Job = {.Run = Mat44fBatch_RunTransformVectors, .Matrix = This, .Input = Vectors, .Output = NewVectors};
+	
+	Mat44fBatch_Run(&Job, Count);
+}
+
+// Same as Mat44f_ApplyTransformation() in mode 0, W is 1 and
+// the resulting W is dropped.
+
+void Mat44fBatch_TransformPoints(Mat44f* This, Vec3f* Points, Vec3f* NewPoints, size_t Count)
+{
+	Mat44fBatchJob Job = {.Run = Mat44fBatch_RunTransformPoints, .Matrix = This, .Input = Points, .Output = NewPoints};
+	
+	Mat44fBatch_Run(&Job, Count);
+}
+
+// NewW may be NULL, the clip W is only needed for culling.
+
+void Mat44fBatch_TransformPointsSoA(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count)
+{
+	Mat44fBatchJob Job = {.Run = Mat44fBatch_RunTransformPointsSoA, .Matrix = This, .X = X, .Y = Y, .Z = Z, .NewX = NewX, .NewY = NewY, .NewZ = NewZ, .NewW = NewW};
+	
+	Mat44fBatch_Run(&Job, Count);
+}
@@ -0,0 +1,62 @@
+/*
+ * Mat44fBatch.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef MAT_44F_BATCH_H
+#define MAT_44F_BATCH_H
+
+#include <stddef.h>
+
+#include "Mat44f.h"
+
+/* <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+ * Notes : Mat44fBatch
+ * 
+ * Transforme des tableaux contigus en un seul appel avec
+ * les kernels du backend courant (voir Mat44fBackend).
+ * 
+ * AoS --> Vec3f (W = 1) ou Vec4f
+ * SoA --> tableaux X, Y, Z séparés, W en sortie optionnel
+ * 
+ * Avec Mat44fBatch_SetThreads(), les lots d'au moins
+ * MAT_44F_BATCH_PARALLEL_MIN éléments sont partagés entre
+ * les threads et le thread appelant. Sinon tout se fait
+ * sur le thread appelant. Les appels sont sérialisés.
+ * 
+ * Les sorties peuvent être les entrées (sur place). Les
+ * résultats ne dépendent pas du nombre de threads.
+ * 
+ */
+
+#define MAT_44F_BATCH_THREADS_MAX 16
+#define MAT_44F_BATCH_PARALLEL_MIN 16384
+
+int Mat44fBatch_SetThreads(int ThreadsCount);
+int Mat44fBatch_GetThreads(void);
+
+void Mat44fBatch_MultiplyArray(Mat44f* This, Mat44f* Others, Mat44f* Results, size_t Count);
+void Mat44fBatch_ModelViewProjection(Mat44f* Projection, Mat44f* View, Mat44f* Models, Mat44f* Results, size_t Count);
+void Mat44fBatch_TransformVectors(Mat44f* This, Vec4f* Vectors, Vec4f* NewVectors, size_t Count);
+void Mat44fBatch_TransformPoints(Mat44f* This, Vec3f* Points, Vec3f* NewPoints, size_t Count);
+void Mat44fBatch_TransformPointsSoA(Mat44f* This, const float* X, const float* Y, const float* Z, float* NewX, float* NewY, float* NewZ, float* NewW, size_t Count);
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * CameraUniformBuffer.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CameraUniformBuffer.h"
+
+_Static_assert(sizeof(CameraBlock) == CAMERA_BLOCK_SIZE, "CameraBlock must match the std140 Camera struct");
+
+void CameraUniformBuffer_SetCamera(CameraUniformBuffer* This, int Index, Mat44f* ProjectionMatrix, Mat44f* InvProjectionMatrix, Mat44f* ViewMatrix, Mat44f* InvViewMatrix, int Width, int Height, int PlaneID)
+{
+	CameraBlock* Block = &This->Blocks[Index];
+	
+	Block->ProjectionMatrix = *ProjectionMatrix;
+	Block->InvProjectionMatrix = *InvProjectionMatrix;
+	Block->ViewMatrix = *ViewMatrix;
+	Block->InvViewMatrix = *InvViewMatrix;
+	
+	Block->Viewport[0] = 0.0f;
+	Block->Viewport[1] = 0.0f;
+	Block->Viewport[2] = (GLfloat) Width;
+	Block->Viewport[3] = (GLfloat) Height;
+	
+	Block->PlaneID[0] = PlaneID;
+}
+
+// Orphans the previous storage so the upload never waits on a draw still reading it.
+
+void CameraUniformBuffer_Upload(CameraUniformBuffer* This)
+{
+	GLsizeiptr Size = (GLsizeiptr) sizeof(CameraBlock) * This->Count;
+	
+	glBindBuffer(GL_UNIFORM_BUFFER, This->Buffer);
+	glBufferData(GL_UNIFORM_BUFFER, Size, NULL, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, Size, This->Blocks);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Updates one block in place, for the odd change after the frame upload.
+
+void CameraUniformBuffer_UploadCamera(CameraUniformBuffer* This, int Index)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, This->Buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr) sizeof(CameraBlock) * Index, sizeof(CameraBlock), &This->Blocks[Index]);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void CameraUniformBuffer_BindCamera(CameraUniformBuffer* This, int Index)
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, This->Buffer, (GLintptr) sizeof(CameraBlock) * Index, sizeof(CameraBlock));
+}
+
+void CameraUniformBuffer_BindAll(CameraUniformBuffer* This)
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, This->Buffer);
+}
+
+void CameraUniformBuffer_Initialize(CameraUniformBuffer* This)
+{
+	GLint Alignment = 0;
+	
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Alignment);
+	
+	if (Alignment > 0 && CAMERA_BLOCK_SIZE % Alignment != 0)
+	{
+		fprintf(stderr, "CameraUniformBuffer->Initialize() : Unsupported uniform buffer alignment ! : %d\n", Alignment);
+	}
+	
+	glGenBuffers(1, &This->Buffer);
+	CameraUniformBuffer_Upload(This);
+}
+
+// The staging blocks are kept, the widget may be realized again.
+
+void CameraUniformBuffer_Wipeout(CameraUniformBuffer* This)
+{
+	glDeleteBuffers(1, &This->Buffer);
+	This->Buffer = 0;
+}
+
+void CameraUniformBuffer_Init(CameraUniformBuffer* This, int Count)
+{
+	This->Buffer = 0;
+	This->Count = Count;
+	This->Blocks = calloc(Count, sizeof(CameraBlock));
+	
+	if (This->Blocks == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		Mat44f_Identity(&This->Blocks[Index].ProjectionMatrix);
+		Mat44f_Identity(&This->Blocks[Index].ViewMatrix);
+		Mat44f_Identity(&This->Blocks[Index].InvProjectionMatrix);
+		Mat44f_Identity(&This->Blocks[Index].InvViewMatrix);
+	}
+}
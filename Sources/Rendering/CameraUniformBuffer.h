@@ -0,0 +1,78 @@
+/*
+ * CameraUniformBuffer.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef CAMERA_UNIFORM_BUFFER_H
+#define CAMERA_UNIFORM_BUFFER_H
+
+#include <epoxy/gl.h>
+
+#include "Mat44f.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// One std140 CameraBlock per camera, all of them in a
+// single uniform buffer uploaded once per frame. A shader
+// drawing one view declares "Camera Cam" in the block and
+// gets its camera bound by range, a shader drawing many
+// views declares an array of Camera and gets them all.
+//
+// The block is padded to CAMERA_BLOCK_SIZE, a multiple of
+// every possible GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT (256
+// at most), so the range offsets and the std140 array
+// stride are one and the same.
+
+#define CAMERA_BLOCK_BINDING 0
+#define CAMERA_BLOCK_SIZE 512
+
+// Mirrors the Camera struct declared by the shaders
+
+typedef struct CameraBlock
+{
+	Mat44f ProjectionMatrix;
+	Mat44f ViewMatrix;
+	Mat44f InvProjectionMatrix;
+	Mat44f InvViewMatrix;
+	GLfloat Viewport[4]; // 0, 0, Width, Height
+	GLint PlaneID[4];    // x: 0: X-Z, 1: X-Y, 2: Y-Z
+	GLfloat Padding[56];
+} CameraBlock;
+
+typedef struct CameraUniformBuffer CameraUniformBuffer;
+
+struct CameraUniformBuffer
+{
+	GLuint Buffer;
+	int Count;
+	CameraBlock* Blocks;
+};
+
+void CameraUniformBuffer_SetCamera(CameraUniformBuffer*, int, Mat44f*, Mat44f*, Mat44f*, Mat44f*, int, int, int);
+void CameraUniformBuffer_Upload(CameraUniformBuffer*);
+void CameraUniformBuffer_UploadCamera(CameraUniformBuffer*, int);
+void CameraUniformBuffer_BindCamera(CameraUniformBuffer*, int);
+void CameraUniformBuffer_BindAll(CameraUniformBuffer*);
+
+void CameraUniformBuffer_Initialize(CameraUniformBuffer*);
+void CameraUniformBuffer_Wipeout(CameraUniformBuffer*);
+void CameraUniformBuffer_Init(CameraUniformBuffer*, int);
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * FiniteGridMultiViewShader.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+
+#include "FiniteGridMultiViewShader.h"
+
+static void FiniteGridMultiViewShader_BindAttribute(GLuint ProgramID)
+{
+    glBindFragDataLocation(ProgramID, 0, "FragColor");
+    glBindFragDataLocation(ProgramID, 1, "BrightColor");
+}
+
+void FiniteGridMultiViewShader_Bind(FiniteGridMultiViewShader* This)
+{
+	glUseProgram(This->ShaderProg.GetProgramID(&This->ShaderProg));
+}
+
+void FiniteGridMultiViewShader_Unbind(FiniteGridMultiViewShader* This)
+{
+	glUseProgram(0);
+}
+
+void FiniteGridMultiViewShader_SendGridSize(FiniteGridMultiViewShader* This, float Value)
+{
+	This->ShaderProg.SendUniform1f(&This->ShaderProg, This->UniformGridSize, Value);
+}
+
+void FiniteGridMultiViewShader_SendGridCellSize(FiniteGridMultiViewShader* This, float Value)
+{
+	This->ShaderProg.SendUniform1f(&This->ShaderProg, This->UniformGridCellSize, Value);
+}
+
+void FiniteGridMultiViewShader_SendGridColorThin(FiniteGridMultiViewShader* This, Col4f* Color)
+{
+	This->ShaderProg.SendUniformCol4fv(&This->ShaderProg, This->UniformGridColorThin, Color);
+}
+
+void FiniteGridMultiViewShader_SendGridColorThick(FiniteGridMultiViewShader* This, Col4f* Color)
+{
+	This->ShaderProg.SendUniformCol4fv(&This->ShaderProg, This->UniformGridColorThick, Color);
+}
+
+void FiniteGridMultiViewShader_SendViewNames(FiniteGridMultiViewShader* This, GLint* ViewNames, GLsizei Count)
+{
+	This->ShaderProg.SendUniform1iv(&This->ShaderProg, This->UniformViewNames, ViewNames, Count);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Without the extension the program is not even submitted
+// and IsReady() stays FALSE.
+
+void FiniteGridMultiViewShader_Initialize(FiniteGridMultiViewShader* This, char* Path)
+{
+	if (!epoxy_has_gl_extension("GL_ARB_shader_viewport_layer_array"))
+	{
+		return;
+	}
+	
+	This->ShaderProg.SubmitRenderingShader(&This->ShaderProg, Path, "FiniteGridMultiView-vs.glsl", NULL, "FiniteGrid-fs.glsl", FiniteGridMultiViewShader_BindAttribute);
+}
+
+static void FiniteGridMultiViewShader_Setup(FiniteGridMultiViewShader* This)
+{
+	// The matrices and the plane come from the camera of the view, see CameraUniformBuffer.
+	
+	GLuint BlockIndex = glGetUniformBlockIndex(This->ShaderProg.ProgramID, "CameraBlock");
+	
+	if (BlockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(This->ShaderProg.ProgramID, BlockIndex, CAMERA_BLOCK_BINDING);
+	}
+	
+	This->Bind(This);
+	This->ShaderProg.GetUniformLocations(&This->ShaderProg);
+	This->Unbind(This);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Never blocks. The first call seeing the program linked
+// binds the camera block and fetches the uniform locations.
+
+int FiniteGridMultiViewShader_IsReady(FiniteGridMultiViewShader* This)
+{
+	if (This->ShaderProg.IsPending == FALSE)
+	{
+		return This->ShaderProg.GetProgramID(&This->ShaderProg) != 0;
+	}
+	
+	if (This->ShaderProg.IsReady(&This->ShaderProg) == FALSE || This->ShaderProg.Finish(&This->ShaderProg) == FALSE)
+	{
+		return FALSE;
+	}
+	
+	FiniteGridMultiViewShader_Setup(This);
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The previous program stays in use if the edited sources
+// do not link. Either way the uniform values must be sent
+// again by the caller.
+
+int FiniteGridMultiViewShader_Reload(FiniteGridMultiViewShader* This)
+{
+	if (This->ShaderProg.Reload(&This->ShaderProg) == FALSE)
+	{
+		return FALSE;
+	}
+	
+	FiniteGridMultiViewShader_Setup(This);
+	
+	return TRUE;
+}
+
+void FiniteGridMultiViewShader_Wipeout(FiniteGridMultiViewShader* This)
+{
+	This->ShaderProg.Wipeout(&This->ShaderProg);
+}
+
+void FiniteGridMultiViewShader_Init(FiniteGridMultiViewShader* This)
+{
+	This->Bind = FiniteGridMultiViewShader_Bind;
+	This->Unbind = FiniteGridMultiViewShader_Unbind;
+	This->IsReady = FiniteGridMultiViewShader_IsReady;
+	
+	This->SendGridSize = FiniteGridMultiViewShader_SendGridSize;
+	This->SendGridCellSize = FiniteGridMultiViewShader_SendGridCellSize;
+	This->SendGridColorThin = FiniteGridMultiViewShader_SendGridColorThin;
+	This->SendGridColorThick = FiniteGridMultiViewShader_SendGridColorThick;
+	This->SendViewNames = FiniteGridMultiViewShader_SendViewNames;
+	
+	This->Reload = FiniteGridMultiViewShader_Reload;
+	This->Initialize = FiniteGridMultiViewShader_Initialize;
+	This->Wipeout = FiniteGridMultiViewShader_Wipeout;
+	
+	ShaderProgram_Init(&This->ShaderProg, "FiniteGridMultiView");
+	
+	This->UniformGridSize = This->ShaderProg.AddUniform(&This->ShaderProg, "GridSize");
+	This->UniformGridCellSize = This->ShaderProg.AddUniform(&This->ShaderProg, "GridCellSize");
+	This->UniformGridColorThin = This->ShaderProg.AddUniform(&This->ShaderProg, "GridColorThin");
+	This->UniformGridColorThick = This->ShaderProg.AddUniform(&This->ShaderProg, "GridColorThick");
+	This->UniformViewNames = This->ShaderProg.AddUniform(&This->ShaderProg, "ViewNames");
+}
@@ -0,0 +1,71 @@
+/*
+ * FiniteGridMultiViewShader.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef FINITE_GRID_MULTI_VIEW_SHADER_H
+#define FINITE_GRID_MULTI_VIEW_SHADER_H
+
+#include "Col4f.h"
+#include "Mat44f.h"
+
+#include "ShaderProgram.h"
+#include "CameraUniformBuffer.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Draws the grid of up to MULTI_VIEW_MAX views with one
+// instanced draw, instance N going to viewport N with the
+// camera ViewNames[N] of the whole CameraBlock array. Needs
+// GL_ARB_shader_viewport_layer_array to write the
+// viewport index from the vertex shader.
+
+#define MULTI_VIEW_MAX 5
+
+typedef struct FiniteGridMultiViewShader FiniteGridMultiViewShader;
+
+struct FiniteGridMultiViewShader
+{
+	ShaderProgram ShaderProg;
+	
+	int UniformGridSize;
+	int UniformGridCellSize;
+	int UniformGridColorThin;
+	int UniformGridColorThick;
+	int UniformViewNames;
+	
+	void (*Bind)(FiniteGridMultiViewShader*);
+	void (*Unbind)(FiniteGridMultiViewShader*);
+	int (*IsReady)(FiniteGridMultiViewShader*);
+	
+	void (*SendGridSize)(FiniteGridMultiViewShader*, float);
+	void (*SendGridCellSize)(FiniteGridMultiViewShader*, float);
+	void (*SendGridColorThin)(FiniteGridMultiViewShader*, Col4f*);
+	void (*SendGridColorThick)(FiniteGridMultiViewShader*, Col4f*);
+	void (*SendViewNames)(FiniteGridMultiViewShader*, GLint*, GLsizei);
+	
+	int (*Reload)(FiniteGridMultiViewShader*);
+	void (*Initialize)(FiniteGridMultiViewShader*, char*);
+	void (*Wipeout)(FiniteGridMultiViewShader*);
+};
+
+void FiniteGridMultiViewShader_Init(FiniteGridMultiViewShader*);
+
+#endif
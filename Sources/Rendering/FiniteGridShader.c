@@ -22,6 +22,8 @@
  */
 
 
+#include <stdio.h>
+
 #include "FiniteGridShader.h"
 
 static void FiniteGridShader_BindAttribute(GLuint ProgramID)
@@ -30,92 +32,174 @@ static void FiniteGridShader_BindAttribute(GLuint ProgramID)
     glBindFragDataLocation(ProgramID, 1, "BrightColor");
 }
 
-void FiniteGridShader_Bind(FiniteGridShader* This)
+static ShaderProgram* FiniteGridShader_Plane(FiniteGridShader* This, int PlaneID)
 {
-	glUseProgram(This->ShaderProg.GetProgramID(&This->ShaderProg));
+	return This->Variants.Get(&This->Variants, This->Planes[PlaneID]);
 }
 
-void FiniteGridShader_Unbind(FiniteGridShader* This)
+void FiniteGridShader_Bind(FiniteGridShader* This, int PlaneID)
 {
-	glUseProgram(0);
+	This->BoundPlane = FiniteGridShader_Plane(This, PlaneID);
+	glUseProgram(This->BoundPlane->GetProgramID(This->BoundPlane));
 }
 
-void FiniteGridShader_SendProjectionMatrix(FiniteGridShader* This, Mat44f* Matrix)
-{
-	This->ShaderProg.SendUniformMatrix4fv(&This->ShaderProg, "ProjectionMatrix", Matrix);
-}
-
-void FiniteGridShader_SendViewMatrix(FiniteGridShader* This, Mat44f* Matrix)
+void FiniteGridShader_Unbind(FiniteGridShader* This)
 {
-	This->ShaderProg.SendUniformMatrix4fv(&This->ShaderProg, "ViewMatrix", Matrix);
+	glUseProgram(0);
 }
 
 void FiniteGridShader_SendGridSize(FiniteGridShader* This, float Value)
 {
-	This->ShaderProg.SendUniform1f(&This->ShaderProg, "GridSize", Value);
+	This->BoundPlane->SendUniform1f(This->BoundPlane, This->UniformGridSize, Value);
 }
 
 void FiniteGridShader_SendGridCellSize(FiniteGridShader* This, float Value)
 {
-	This->ShaderProg.SendUniform1f(&This->ShaderProg, "GridCellSize", Value);
+	This->BoundPlane->SendUniform1f(This->BoundPlane, This->UniformGridCellSize, Value);
 }
 
 void FiniteGridShader_SendGridColorThin(FiniteGridShader* This, Col4f* Color)
 {
-	This->ShaderProg.SendUniformCol4fv(&This->ShaderProg, "GridColorThin", Color);
+	This->BoundPlane->SendUniformCol4fv(This->BoundPlane, This->UniformGridColorThin, Color);
 }
 
 void FiniteGridShader_SendGridColorThick(FiniteGridShader* This, Col4f* Color)
 {
-	This->ShaderProg.SendUniformCol4fv(&This->ShaderProg, "GridColorThick", Color);
+	This->BoundPlane->SendUniformCol4fv(This->BoundPlane, This->UniformGridColorThick, Color);
 }
 
-void FiniteGridShader_SendPlaneID(FiniteGridShader* This, int Value)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Only submits the variants, they compile side by side and
+// IsReady() completes their setup once the driver is done.
+
+void FiniteGridShader_Initialize(FiniteGridShader* This, char* Path)
 {
-	This->ShaderProg.SendUniform1i(&This->ShaderProg, "PlaneID", Value);
+	This->Variants.SetSources(&This->Variants, Path, "FiniteGrid-vs.glsl", NULL, "FiniteGrid-fs.glsl", FiniteGridShader_BindAttribute);
+	
+	for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+	{
+		char Define[32];
+		char* Defines[1] = {Define};
+		
+		snprintf(Define, sizeof(Define), "PLANE_ID %d", PlaneID);
+		This->Planes[PlaneID] = This->Variants.GetVariant(&This->Variants, Defines, 1);
+	}
 }
 
-void FiniteGridShader_Initialize(FiniteGridShader* This, char* Path)
+static void FiniteGridShader_Setup(FiniteGridShader* This, int PlaneID)
 {
-	This->ShaderProg.CreateRenderingShader(&This->ShaderProg, Path, "FiniteGrid-vs.glsl", NULL, "FiniteGrid-fs.glsl", FiniteGridShader_BindAttribute);
+	ShaderProgram* Program = FiniteGridShader_Plane(This, PlaneID);
+	
+	// The matrices come from the camera of the view, see CameraUniformBuffer.
 	
-	This->Bind(This);
-	This->ShaderProg.GetUniformLocations(&This->ShaderProg);
+	GLuint BlockIndex = glGetUniformBlockIndex(Program->ProgramID, "CameraBlock");
+	
+	if (BlockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(Program->ProgramID, BlockIndex, CAMERA_BLOCK_BINDING);
+	}
+	
+	This->Bind(This, PlaneID);
+	Program->GetUniformLocations(Program);
 	This->Unbind(This);
 }
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Never blocks, TRUE once every plane is linked. The first
+// call seeing a variant linked binds the camera block and
+// fetches the uniform locations.
+
+int FiniteGridShader_IsReady(FiniteGridShader* This)
+{
+	int IsReady = TRUE;
+	
+	for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+	{
+		ShaderProgram* Program = FiniteGridShader_Plane(This, PlaneID);
+		
+		if (Program == NULL)
+		{
+			IsReady = FALSE;
+		}
+		else if (Program->IsPending == FALSE)
+		{
+			IsReady = IsReady && Program->GetProgramID(Program) != 0;
+		}
+		else if (Program->IsReady(Program) && Program->Finish(Program))
+		{
+			FiniteGridShader_Setup(This, PlaneID);
+		}
+		else
+		{
+			IsReady = FALSE;
+		}
+	}
+	
+	return IsReady;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A variant whose edited sources do not link keeps its
+// previous program. Returns TRUE if one was rebuilt, its
+// uniform values must then be sent again by the caller.
+
+int FiniteGridShader_Reload(FiniteGridShader* This)
+{
+	int IsReloaded = FALSE;
+	
+	for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+	{
+		ShaderProgram* Program = FiniteGridShader_Plane(This, PlaneID);
+		
+		if (Program != NULL && Program->Reload(Program))
+		{
+			FiniteGridShader_Setup(This, PlaneID);
+			IsReloaded = TRUE;
+		}
+	}
+	
+	return IsReloaded;
+}
+
 void FiniteGridShader_Wipeout(FiniteGridShader* This)
 {
-	This->ShaderProg.Wipeout(&This->ShaderProg);
+	This->Variants.Wipeout(&This->Variants);
+	
+	for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+	{
+		This->Planes[PlaneID] = SlotMapHandle_Invalid;
+	}
+	
+	This->BoundPlane = NULL;
 }
 
 void FiniteGridShader_Init(FiniteGridShader* This)
 {
 	This->Bind = FiniteGridShader_Bind;
 	This->Unbind = FiniteGridShader_Unbind;
-	This->SendProjectionMatrix = FiniteGridShader_SendProjectionMatrix;
 	
-	This->SendViewMatrix = FiniteGridShader_SendViewMatrix;
 	This->SendGridSize = FiniteGridShader_SendGridSize;
 	This->SendGridCellSize = FiniteGridShader_SendGridCellSize;
 	
 	This->SendGridColorThin = FiniteGridShader_SendGridColorThin;
 	This->SendGridColorThick = FiniteGridShader_SendGridColorThick;
-	This->SendPlaneID = FiniteGridShader_SendPlaneID;
 	
+	This->IsReady = FiniteGridShader_IsReady;
+	This->Reload = FiniteGridShader_Reload;
 	This->Initialize = FiniteGridShader_Initialize;
 	This->Wipeout = FiniteGridShader_Wipeout;
 	
-	ShaderProgram_Init(&This->ShaderProg, "FiniteGrid");
+	ShaderVariants_Init(&This->Variants, "FiniteGrid");
+	
+	for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+	{
+		This->Planes[PlaneID] = SlotMapHandle_Invalid;
+	}
 	
-	This->ShaderProg.AddUniform(&This->ShaderProg, "ProjectionMatrix");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "ViewMatrix");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "GridSize");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "GridCellSize");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "GridColorThin");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "GridColorThick");
-	This->ShaderProg.AddUniform(&This->ShaderProg, "PlaneID");
+	This->BoundPlane = NULL;
+	
+	This->UniformGridSize = This->Variants.AddUniform(&This->Variants, "GridSize");
+	This->UniformGridCellSize = This->Variants.AddUniform(&This->Variants, "GridCellSize");
+	This->UniformGridColorThin = This->Variants.AddUniform(&This->Variants, "GridColorThin");
+	This->UniformGridColorThick = This->Variants.AddUniform(&This->Variants, "GridColorThick");
 }
-
-
-
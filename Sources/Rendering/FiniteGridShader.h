@@ -29,24 +29,41 @@
 #include "Mat44f.h"
 
 #include "ShaderProgram.h"
+#include "ShaderVariants.h"
+#include "CameraUniformBuffer.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// One variant per grid plane, 0: X-Z, 1: X-Y, 2: Y-Z, built
+// with PLANE_ID defined so no stage branches on the plane.
+// Bind() selects the variant, the Send methods go to the
+// bound one and the grid infos must be sent to every plane.
+// The planes are held by handle, the variants own the programs.
+
+#define FINITE_GRID_PLANE_MAX 3
 
 typedef struct FiniteGridShader FiniteGridShader;
 
 struct FiniteGridShader
 {
-	ShaderProgram ShaderProg;
+	ShaderVariants Variants;
+	SlotMapHandle Planes[FINITE_GRID_PLANE_MAX];
+	ShaderProgram* BoundPlane;
+	
+	int UniformGridSize;
+	int UniformGridCellSize;
+	int UniformGridColorThin;
+	int UniformGridColorThick;
 	
-	void (*Bind)(FiniteGridShader*);
+	void (*Bind)(FiniteGridShader*, int);
 	void (*Unbind)(FiniteGridShader*);
-	void (*SendProjectionMatrix)(FiniteGridShader*, Mat44f*);
 	
-	void (*SendViewMatrix)(FiniteGridShader*, Mat44f*);
 	void (*SendGridSize)(FiniteGridShader*, float);
 	void (*SendGridCellSize)(FiniteGridShader*, float);
 	
 	void (*SendGridColorThin)(FiniteGridShader*, Col4f*);
 	void (*SendGridColorThick)(FiniteGridShader*, Col4f*);
-	void (*SendPlaneID)(FiniteGridShader*, int);
+	int (*IsReady)(FiniteGridShader*);
+	int (*Reload)(FiniteGridShader*);
 	void (*Initialize)(FiniteGridShader*, char*);
 	void (*Wipeout)(FiniteGridShader*);
 };
@@ -54,5 +71,3 @@ struct FiniteGridShader
 void FiniteGridShader_Init(FiniteGridShader*);
 
 #endif
-
-
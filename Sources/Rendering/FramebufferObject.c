@@ -23,10 +23,82 @@
 
 
 #include "FramebufferObject.h"
+#include "Trace.h"
+
+static int FBO_IsScene3D(FramebufferObject* This)
+{
+	return This->Type == FBO_TYPE_SCENE_3D || This->Type == FBO_TYPE_SCENE_3D_NO_BRIGHT;
+}
+
+static GLenum FBO_ColorInternalFormat(FramebufferObjectColorFormat Format)
+{
+	switch (Format)
+	{
+		case FBO_COLOR_FORMAT_RGBA16F:
+			return GL_RGBA16F;
+		case FBO_COLOR_FORMAT_R11G11B10F:
+			return GL_R11F_G11F_B10F;
+		case FBO_COLOR_FORMAT_RGBA32F:
+			return GL_RGBA32F;
+		default:
+			return GL_RGBA8;
+	}
+}
+
+static size_t FBO_ColorBytesPerPixel(FramebufferObjectColorFormat Format)
+{
+	switch (Format)
+	{
+		case FBO_COLOR_FORMAT_RGBA16F:
+			return 8;
+		case FBO_COLOR_FORMAT_RGBA32F:
+			return 16;
+		default:
+			return 4;
+	}
+}
+
+static GLenum FBO_DepthInternalFormat(FramebufferObjectDepthFormat Format)
+{
+	switch (Format)
+	{
+		case FBO_DEPTH_FORMAT_DEPTH16:
+			return GL_DEPTH_COMPONENT16;
+		case FBO_DEPTH_FORMAT_DEPTH32F:
+			return GL_DEPTH_COMPONENT32F;
+		default:
+			return GL_DEPTH_COMPONENT24;
+	}
+}
+
+static size_t FBO_DepthBytesPerPixel(FramebufferObjectDepthFormat Format)
+{
+	switch (Format)
+	{
+		case FBO_DEPTH_FORMAT_NONE:
+			return 0;
+		case FBO_DEPTH_FORMAT_DEPTH16:
+			return 2;
+		default:
+			return 4;
+	}
+}
+
+static void FBO_RenderbufferStorage(FramebufferObject* This, GLenum InternalFormat)
+{
+	if (This->Descriptor.Samples > 1)
+	{
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, This->Descriptor.Samples, InternalFormat, This->Width, This->Height);
+	}
+	else
+	{
+		glRenderbufferStorage(GL_RENDERBUFFER, InternalFormat, This->Width, This->Height);
+	}
+}
 
 static void FBO_CreateColorBufferAttachment(FramebufferObject* This, FramebufferObjectAttachementID ID, int Attachement)
 {
-	if (This->Type == FBO_TYPE_SCENE_3D)
+	if (FBO_IsScene3D(This))
 	{
 		int DestinationIndex = 0;
 		
@@ -40,16 +112,7 @@ static void FBO_CreateColorBufferAttachment(FramebufferObject* This, Framebuffer
 		
 		glGenRenderbuffers(1, &This->Attachements[DestinationIndex].AttachementID);
 		glBindRenderbuffer(GL_RENDERBUFFER, This->Attachements[DestinationIndex].AttachementID);
-		
-		if (This->Multisample == TRUE)
-		{
-			glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGBA8, This->Width, This->Height);
-		}
-		else
-		{
-			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, This->Width, This->Height);
-		}
-		
+		FBO_RenderbufferStorage(This, FBO_ColorInternalFormat(This->Descriptor.ColorFormat));
 		glFramebufferRenderbuffer(GL_FRAMEBUFFER, Attachement, GL_RENDERBUFFER, This->Attachements[DestinationIndex].AttachementID);
 		
 	}
@@ -57,36 +120,32 @@ static void FBO_CreateColorBufferAttachment(FramebufferObject* This, Framebuffer
 
 static void FBO_CreateDepthBufferAttachment(FramebufferObject* This, FramebufferObjectAttachementID ID)
 {
-	if (This->Type == FBO_TYPE_SCENE_3D)
+	if (FBO_IsScene3D(This) && This->Descriptor.DepthFormat != FBO_DEPTH_FORMAT_NONE)
 	{
 		This->Attachements[2].ID = ID;
 		This->Attachements[2].Type = FBO_ATTACHEMENT_TYPE_RENDER_DEPTH_BUFFER;
 		
 		glGenRenderbuffers(1, &This->Attachements[2].AttachementID);
 		glBindRenderbuffer(GL_RENDERBUFFER, This->Attachements[2].AttachementID);
-		
-		if (This->Multisample == TRUE)
-		{
-			glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH_COMPONENT24, This->Width, This->Height);
-		}
-		else
-		{
-			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, This->Width, This->Height);
-		}
-		
+		FBO_RenderbufferStorage(This, FBO_DepthInternalFormat(This->Descriptor.DepthFormat));
 		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,This->Attachements[2].AttachementID);
 	}
 	
 }
 
-static void FBO_CreateTextureRGBA32F(FramebufferObject* This, FramebufferObjectAttachementID ID, int Attachement)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Immutable storage, the texture is never resized in place,
+// FramebufferObject_Rebuilt() creates a new one instead.
+
+static void FBO_CreateTexture(FramebufferObject* This, FramebufferObjectAttachementID ID, int Attachement)
 {
 	if (This->Type == FBO_TYPE_COLOR_OUTPUT)
 	{
 		This->Attachements[0].ID = ID;
+		This->Attachements[0].Type = FBO_ATTACHEMENT_TYPE_COLOR_TEXTURE;
 		glGenTextures(1, &This->Attachements[0].AttachementID);
 		glBindTexture(GL_TEXTURE_2D, This->Attachements[0].AttachementID);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, This->Width, This->Height, 0, GL_RGBA, GL_FLOAT, NULL);
+		glTexStorage2D(GL_TEXTURE_2D, 1, FBO_ColorInternalFormat(This->Descriptor.ColorFormat), This->Width, This->Height);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -110,9 +169,15 @@ static void FBO_Builder(FramebufferObject* This)
 		FBO_CreateDepthBufferAttachment(This, FBO_ATTACHEMENT_ID_DEPTH_BUFFER);
 		glDrawBuffers(2, &DrawBuffers[0]);
 	}
+	else if (This->Type == FBO_TYPE_SCENE_3D_NO_BRIGHT)
+	{
+		FBO_CreateColorBufferAttachment(This, FBO_ATTACHEMENT_ID_COLOR_BUFFER, GL_COLOR_ATTACHMENT0);
+		FBO_CreateDepthBufferAttachment(This, FBO_ATTACHEMENT_ID_DEPTH_BUFFER);
+		glDrawBuffers(1, &DrawBuffers[0]);
+	}
 	else if (This->Type == FBO_TYPE_COLOR_OUTPUT)
 	{
-		FBO_CreateTextureRGBA32F(This, FBO_ATTACHEMENT_ID_COLOR_TEXTURE, GL_COLOR_ATTACHMENT0);
+		FBO_CreateTexture(This, FBO_ATTACHEMENT_ID_COLOR_TEXTURE, GL_COLOR_ATTACHMENT0);
 		glDrawBuffers(1, &DrawBuffers[0]);
 	}
 	
@@ -120,14 +185,122 @@ static void FBO_Builder(FramebufferObject* This)
 	
 }
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Defaults matching what the engine used to hardcode, an
+// RGBA8 color and a 24 bits depth. A color output is
+// single sampled whatever Samples says.
+
+void FramebufferObjectDescriptor_Init(FramebufferObjectDescriptor* This, FramebufferObjectType Type, int Samples)
+{
+	This->Type = Type;
+	This->Samples = Samples > 1 ? Samples : 1;
+	This->ColorFormat = FBO_COLOR_FORMAT_RGBA8;
+	This->DepthFormat = FBO_DEPTH_FORMAT_DEPTH24;
+	
+	if (Type == FBO_TYPE_COLOR_OUTPUT)
+	{
+		This->Samples = 1;
+		This->DepthFormat = FBO_DEPTH_FORMAT_NONE;
+	}
+}
+
+int FramebufferObjectDescriptor_Equals(const FramebufferObjectDescriptor* A, const FramebufferObjectDescriptor* B)
+{
+	return A->Type == B->Type && A->Samples == B->Samples && A->ColorFormat == B->ColorFormat && A->DepthFormat == B->DepthFormat;
+}
+
+size_t FramebufferObject_GetBytesUsed(FramebufferObject* This)
+{
+	if (This->Framebuffer == 0)
+	{
+		return 0;
+	}
+	
+	size_t ColorBuffers = This->Type == FBO_TYPE_SCENE_3D ? 2 : 1;
+	size_t DepthBytes = This->Type == FBO_TYPE_COLOR_OUTPUT ? 0 : FBO_DepthBytesPerPixel(This->Descriptor.DepthFormat);
+	size_t BytesPerPixel = ColorBuffers * FBO_ColorBytesPerPixel(This->Descriptor.ColorFormat) + DepthBytes;
+	
+	return (size_t) This->Width * (size_t) This->Height * (size_t) This->Descriptor.Samples * BytesPerPixel;
+}
+
+static int FBO_IsPartiallyUsed(FramebufferObject* This)
+{
+	return This->UsedWidth < This->Width || This->UsedHeight < This->Height;
+}
+
+void FramebufferObject_SetUsedSize(FramebufferObject* This, int Width, int Height)
+{
+	This->UsedWidth = Width < This->Width ? Width : This->Width;
+	This->UsedHeight = Height < This->Height ? Height : This->Height;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// By default a scene target is transient, nothing of it is
+// needed past its resolve, while a color output keeps its
+// texture for whoever samples it later.
+
+void FramebufferObject_SetKeepPolicy(FramebufferObject* This, unsigned int KeepPolicy)
+{
+	This->KeepPolicy = KeepPolicy;
+}
+
+// Attachments is a mask of FBO_KEEP_* flags naming the
+// attachments whose contents are dead.
+
+void FramebufferObject_Invalidate(FramebufferObject* This, unsigned int Attachments)
+{
+	GLenum Discards[3];
+	GLsizei Count = 0;
+	
+	if ((Attachments & FBO_KEEP_COLOR) && This->Attachements[0].AttachementID != 0)
+	{
+		Discards[Count++] = GL_COLOR_ATTACHMENT0;
+	}
+	
+	if ((Attachments & FBO_KEEP_BRIGHT) && This->Type == FBO_TYPE_SCENE_3D)
+	{
+		Discards[Count++] = GL_COLOR_ATTACHMENT1;
+	}
+	
+	if ((Attachments & FBO_KEEP_DEPTH) && FBO_IsScene3D(This) && This->Attachements[2].AttachementID != 0)
+	{
+		Discards[Count++] = GL_DEPTH_ATTACHMENT;
+	}
+	
+	if (Count > 0)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, This->Framebuffer);
+		glInvalidateFramebuffer(GL_FRAMEBUFFER, Count, Discards);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+void FramebufferObject_InvalidateDead(FramebufferObject* This)
+{
+	FramebufferObject_Invalidate(This, FBO_KEEP_ALL & ~This->KeepPolicy);
+}
+
 void FramebufferObject_Bind(FramebufferObject* Input)
 {
     glBindFramebuffer(GL_FRAMEBUFFER, Input->Framebuffer);
-    glViewport(0, 0, Input->Width, Input->Height);
+    glViewport(0, 0, Input->UsedWidth, Input->UsedHeight);
+    
+    // Keep glClear() away from the unused part of the target.
+    
+    if (FBO_IsPartiallyUsed(Input))
+    {
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(0, 0, Input->UsedWidth, Input->UsedHeight);
+	}
 }
 
 void FramebufferObject_Unbind(FramebufferObject* Input)
 {
+	if (FBO_IsPartiallyUsed(Input))
+	{
+		glDisable(GL_SCISSOR_TEST);
+	}
+	
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -136,7 +309,7 @@ void FramebufferObject_ResolveToFbo(FramebufferObject* Input, FramebufferObject*
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, Output->Framebuffer);
     glBindFramebuffer(GL_READ_FRAMEBUFFER, Input->Framebuffer);
     glReadBuffer(ReadBuffer);
-    glBlitFramebuffer(0, 0, Input->Width, Input->Height, 0, 0, Output->Width, Output->Height, Mask, GL_NEAREST);
+    glBlitFramebuffer(0, 0, Input->UsedWidth, Input->UsedHeight, 0, 0, Output->UsedWidth, Output->UsedHeight, Mask, GL_NEAREST);
     
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -145,23 +318,43 @@ void FramebufferObject_ResolveToExternal(FramebufferObject* Input, GLuint Frameb
 {
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, Framebuffer);
     glBindFramebuffer(GL_READ_FRAMEBUFFER, Input->Framebuffer);
-    glDrawBuffer(ReadBuffer);
-    glBlitFramebuffer(0, 0, Input->Width, Input->Height, 0, 0, Width, Height, Mask, GL_NEAREST);
+    glReadBuffer(ReadBuffer);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glBlitFramebuffer(0, 0, Input->UsedWidth, Input->UsedHeight, 0, 0, Width, Height, Mask, GL_NEAREST);
+    
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Resolves the Width x Height region starting at (X, Y),
+// one view of an atlas, into the whole external target.
+
+void FramebufferObject_ResolveRegionToExternal(FramebufferObject* Input, int X, int Y, GLuint Framebuffer, int Width, int Height, GLenum ReadBuffer, GLbitfield Mask)
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, Framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Input->Framebuffer);
+    glReadBuffer(ReadBuffer);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glBlitFramebuffer(X, Y, X + Width, Y + Height, 0, 0, Width, Height, Mask, GL_NEAREST);
     
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FramebufferObject_Rebuilt(FramebufferObject* This, int Width, int Height)
 {
+	TRACE_SCOPE("FramebufferObject_Rebuilt");
+	
 	FramebufferObject_Wipeout(This);
 	This->Width = Width;
 	This->Height = Height;
+	This->UsedWidth = Width;
+	This->UsedHeight = Height;
 	FBO_Builder(This);	
 }
 
 void FramebufferObject_Wipeout(FramebufferObject* This)
 {
-	if (This->Type == FBO_TYPE_SCENE_3D)
+	if (FBO_IsScene3D(This))
 	{
 		glDeleteRenderbuffers(1, &This->Attachements[0].AttachementID);
 		glDeleteRenderbuffers(1, &This->Attachements[1].AttachementID);
@@ -183,11 +376,20 @@ void FramebufferObject_Wipeout(FramebufferObject* This)
 	
 }
 
-void FramebufferObject_Init(FramebufferObject* This, int Width, int Height, FramebufferObjectType Type, int IsMultiSample)
+void FramebufferObject_Init(FramebufferObject* This, int Width, int Height, const FramebufferObjectDescriptor* Descriptor)
 {
 	This->Width = Width;
 	This->Height = Height;
-	This->Type = Type;
-	This->Multisample = IsMultiSample;
+	This->UsedWidth = Width;
+	This->UsedHeight = Height;
+	This->Type = Descriptor->Type;
+	This->Descriptor = *Descriptor;
+	This->KeepPolicy = Descriptor->Type == FBO_TYPE_COLOR_OUTPUT ? FBO_KEEP_COLOR : FBO_KEEP_NONE;
+	
+	for (int i = 0; i < 3; i++)
+	{
+		This->Attachements[i].AttachementID = 0;
+	}
+	
 	FBO_Builder(This);
 }
@@ -24,6 +24,7 @@
 #ifndef FRAMEBUFFER_OBJECT_H
 #define FRAMEBUFFER_OBJECT_H
 
+#include <stddef.h>
 #include <epoxy/gl.h>
 
 #ifndef FALSE
@@ -34,16 +35,55 @@
 	#define TRUE 1
 #endif
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// FBO_TYPE_SCENE_3D carries a color and a bright buffer,
+// FBO_TYPE_SCENE_3D_NO_BRIGHT only the color buffer for
+// when no post-processing stage consumes the bright one.
+
 typedef enum FramebufferObjectType
 {
 	FBO_TYPE_SCENE_3D,
+	FBO_TYPE_SCENE_3D_NO_BRIGHT,
 	FBO_TYPE_COLOR_OUTPUT
 } FramebufferObjectType;
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Storage formats. FBO_COLOR_FORMAT_RGBA8 is enough for
+// an LDR scene, the float formats are there for HDR
+// post-processing stages.
+
+typedef enum FramebufferObjectColorFormat
+{
+	FBO_COLOR_FORMAT_RGBA8,
+	FBO_COLOR_FORMAT_RGBA16F,
+	FBO_COLOR_FORMAT_R11G11B10F,
+	FBO_COLOR_FORMAT_RGBA32F
+} FramebufferObjectColorFormat;
+
+typedef enum FramebufferObjectDepthFormat
+{
+	FBO_DEPTH_FORMAT_NONE,
+	FBO_DEPTH_FORMAT_DEPTH16,
+	FBO_DEPTH_FORMAT_DEPTH24,
+	FBO_DEPTH_FORMAT_DEPTH32F
+} FramebufferObjectDepthFormat;
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Everything FramebufferObject_Init needs besides the size.
+// Samples is 1 for a single sampled target. The depth
+// format is ignored by FBO_TYPE_COLOR_OUTPUT.
+
+typedef struct FramebufferObjectDescriptor
+{
+	FramebufferObjectType Type;
+	int Samples;
+	FramebufferObjectColorFormat ColorFormat;
+	FramebufferObjectDepthFormat DepthFormat;
+} FramebufferObjectDescriptor;
+
 typedef enum FramebufferObjectAttachementType
 {
-	FBO_ATTACHEMENT_TYPE_COLOR_TEXTURE_RGBA8,
-    FBO_ATTACHEMENT_TYPE_COLOR_TEXTURE_RGBA32F,
+	FBO_ATTACHEMENT_TYPE_COLOR_TEXTURE,
     FBO_ATTACHEMENT_TYPE_DEPTH_TEXTURE,
     FBO_ATTACHEMENT_TYPE_RENDER_COLOR_BUFFER,
     FBO_ATTACHEMENT_TYPE_RENDER_DEPTH_BUFFER
@@ -64,28 +104,59 @@ typedef struct FramebufferObjectAttachement
 	GLuint AttachementID;
 } FramebufferObjectAttachement;
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Which attachments must survive once an FBO is done with
+// for the frame. Everything else is handed to
+// glInvalidateFramebuffer() so tiled GPUs don't write it
+// back to memory.
+
+#define FBO_KEEP_NONE   0x0u
+#define FBO_KEEP_COLOR  0x1u
+#define FBO_KEEP_BRIGHT 0x2u
+#define FBO_KEEP_DEPTH  0x4u
+#define FBO_KEEP_ALL    0x7u
+
 typedef struct FramebufferObject FramebufferObject;
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Width and Height are the allocated size. UsedWidth and
+// UsedHeight are the sub-rectangle, anchored at the origin,
+// that is rendered into and resolved from, allowing a
+// target to be larger than the view it serves.
+
 struct FramebufferObject
 {
 	int Width;
 	int Height;
+	int UsedWidth;
+	int UsedHeight;
 	FramebufferObjectType Type;
-	int Multisample;
+	FramebufferObjectDescriptor Descriptor;
+	unsigned int KeepPolicy;
 	GLuint Framebuffer;
 	FramebufferObjectAttachement Attachements[3];
 };
 
+void FramebufferObjectDescriptor_Init(FramebufferObjectDescriptor*, FramebufferObjectType, int);
+int FramebufferObjectDescriptor_Equals(const FramebufferObjectDescriptor*, const FramebufferObjectDescriptor*);
+
+size_t FramebufferObject_GetBytesUsed(FramebufferObject*);
+void FramebufferObject_SetUsedSize(FramebufferObject*, int, int);
+void FramebufferObject_SetKeepPolicy(FramebufferObject*, unsigned int);
+void FramebufferObject_Invalidate(FramebufferObject*, unsigned int);
+void FramebufferObject_InvalidateDead(FramebufferObject*);
+
 void FramebufferObject_Bind(FramebufferObject*);
 void FramebufferObject_Unbind(FramebufferObject*);
 
 void FramebufferObject_ResolveToFbo(FramebufferObject*, FramebufferObject*, GLenum, GLbitfield);
 void FramebufferObject_ResolveToExternal(FramebufferObject*, GLuint, int, int, GLenum, GLbitfield);
+void FramebufferObject_ResolveRegionToExternal(FramebufferObject*, int, int, GLuint, int, int, GLenum, GLbitfield);
 
 void FramebufferObject_Rebuilt(FramebufferObject*, int, int);
 void FramebufferObject_Wipeout(FramebufferObject*);
 
-void FramebufferObject_Init(FramebufferObject*, int, int, FramebufferObjectType, int);
+void FramebufferObject_Init(FramebufferObject*, int, int, const FramebufferObjectDescriptor*);
 
 #endif
 
@@ -0,0 +1,267 @@
+/*
+ * FramebufferPool.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdlib.h>
+
+#include "FramebufferPool.h"
+
+static int FramebufferPool_Bucket(int Size)
+{
+	int Step = FRAMEBUFFER_POOL_BUCKET_STEP;
+	
+	Size += Size / 4;
+	
+	return ((Size + Step - 1) / Step) * Step;
+}
+
+static int FramebufferPool_Fits(FramebufferPoolEntry* Entry, int Width, int Height, const FramebufferObjectDescriptor* Descriptor)
+{
+	if (FramebufferObjectDescriptor_Equals(&Entry->Fbo.Descriptor, Descriptor) == FALSE)
+	{
+		return FALSE;
+	}
+	
+	if (Entry->Fbo.Width < Width || Entry->Fbo.Height < Height)
+	{
+		return FALSE;
+	}
+	
+	// Hysteresis, too large a target is left to age out.
+	
+	return Entry->Fbo.Width <= 2 * Width + FRAMEBUFFER_POOL_BUCKET_STEP && Entry->Fbo.Height <= 2 * Height + FRAMEBUFFER_POOL_BUCKET_STEP;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Called once per frame for every entry used in that frame,
+// FrameWidth and FrameHeight hold the largest request it
+// served. Any smaller target would not fit that request.
+
+static void FramebufferPool_Settle(FramebufferPool* This, FramebufferPoolEntry* Entry)
+{
+	int Width = Entry->FrameWidth;
+	int Height = Entry->FrameHeight;
+	
+	Entry->FrameWidth = 0;
+	Entry->FrameHeight = 0;
+	
+	if (Entry->RequestWidth != Width || Entry->RequestHeight != Height)
+	{
+		Entry->RequestWidth = Width;
+		Entry->RequestHeight = Height;
+		Entry->RequestSinceFrame = This->Frame;
+		return;
+	}
+	
+	int BucketWidth = FramebufferPool_Bucket(Width);
+	int BucketHeight = FramebufferPool_Bucket(Height);
+	
+	if (Entry->InUse == FALSE && (Entry->Fbo.Width > BucketWidth || Entry->Fbo.Height > BucketHeight) && This->Frame - Entry->RequestSinceFrame >= FRAMEBUFFER_POOL_SETTLE_FRAMES)
+	{
+		FramebufferObject_Rebuilt(&Entry->Fbo, BucketWidth, BucketHeight);
+	}
+}
+
+static void FramebufferPool_RemoveEntry(FramebufferPool* This, int Index)
+{
+	FramebufferObject_Wipeout(&This->Entries[Index]->Fbo);
+	free(This->Entries[Index]);
+	
+	This->EntriesCount--;
+	This->Entries[Index] = This->Entries[This->EntriesCount];
+	This->Entries[This->EntriesCount] = NULL;
+}
+
+FramebufferObject* FramebufferPool_Acquire(FramebufferPool* This, int Width, int Height, const FramebufferObjectDescriptor* Descriptor)
+{
+	FramebufferPoolEntry* Best = NULL;
+	
+	for (int Index = 0; Index < This->EntriesCount; Index++)
+	{
+		FramebufferPoolEntry* Entry = This->Entries[Index];
+		
+		if (Entry->InUse == FALSE && FramebufferPool_Fits(Entry, Width, Height, Descriptor))
+		{
+			if (Best == NULL || Entry->Fbo.Width * Entry->Fbo.Height < Best->Fbo.Width * Best->Fbo.Height)
+			{
+				Best = Entry;
+			}
+		}
+	}
+	
+	if (Best != NULL)
+	{
+		if (Best->FrameWidth < Width)
+		{
+			Best->FrameWidth = Width;
+		}
+		
+		if (Best->FrameHeight < Height)
+		{
+			Best->FrameHeight = Height;
+		}
+		
+		FramebufferObject_SetUsedSize(&Best->Fbo, Width, Height);
+		Best->InUse = TRUE;
+		Best->LastUsedFrame = This->Frame;
+		return &Best->Fbo;
+	}
+	
+	if (This->EntriesCount == This->EntriesMax)
+	{
+		int EntriesMax = This->EntriesMax * 2;
+		FramebufferPoolEntry** Entries = realloc(This->Entries, sizeof(FramebufferPoolEntry*) * EntriesMax);
+		
+		if (Entries == NULL)
+		{
+			return NULL;
+		}
+		
+		This->Entries = Entries;
+		This->EntriesMax = EntriesMax;
+	}
+	
+	FramebufferPoolEntry* Entry = malloc(sizeof(FramebufferPoolEntry));
+	
+	if (Entry == NULL)
+	{
+		return NULL;
+	}
+	
+	FramebufferObject_Init(&Entry->Fbo, FramebufferPool_Bucket(Width), FramebufferPool_Bucket(Height), Descriptor);
+	FramebufferObject_SetUsedSize(&Entry->Fbo, Width, Height);
+	Entry->InUse = TRUE;
+	Entry->LastUsedFrame = This->Frame;
+	Entry->FrameWidth = Width;
+	Entry->FrameHeight = Height;
+	Entry->RequestWidth = Width;
+	Entry->RequestHeight = Height;
+	Entry->RequestSinceFrame = This->Frame;
+	
+	This->Entries[This->EntriesCount] = Entry;
+	This->EntriesCount++;
+	
+	return &Entry->Fbo;
+}
+
+void FramebufferPool_Release(FramebufferPool* This, FramebufferObject* Fbo)
+{
+	// Fbo is the first member of the entry
+	
+	FramebufferPoolEntry* Entry = (FramebufferPoolEntry*) Fbo;
+	
+	Entry->InUse = FALSE;
+	Entry->LastUsedFrame = This->Frame;
+}
+
+void FramebufferPool_EndFrame(FramebufferPool* This)
+{
+	int Index = 0;
+	
+	while (Index < This->EntriesCount)
+	{
+		FramebufferPoolEntry* Entry = This->Entries[Index];
+		
+		if (Entry->InUse == FALSE && This->Frame - Entry->LastUsedFrame > This->MaxIdleFrames)
+		{
+			// The last entry is moved into this slot, so Index stays the same.
+			
+			FramebufferPool_RemoveEntry(This, Index);
+		}
+		else
+		{
+			if (Entry->FrameWidth > 0)
+			{
+				FramebufferPool_Settle(This, Entry);
+			}
+			
+			Index++;
+		}
+	}
+	
+	This->Frame++;
+}
+
+// Destroys every free target not used during the current frame.
+
+void FramebufferPool_Trim(FramebufferPool* This)
+{
+	int Index = 0;
+	
+	while (Index < This->EntriesCount)
+	{
+		FramebufferPoolEntry* Entry = This->Entries[Index];
+		
+		if (Entry->InUse == FALSE && Entry->LastUsedFrame != This->Frame)
+		{
+			FramebufferPool_RemoveEntry(This, Index);
+		}
+		else
+		{
+			Index++;
+		}
+	}
+}
+
+int FramebufferPool_GetCount(FramebufferPool* This)
+{
+	return This->EntriesCount;
+}
+
+size_t FramebufferPool_GetBytesUsed(FramebufferPool* This)
+{
+	size_t Bytes = 0;
+	
+	for (int Index = 0; Index < This->EntriesCount; Index++)
+	{
+		Bytes += FramebufferObject_GetBytesUsed(&This->Entries[Index]->Fbo);
+	}
+	
+	return Bytes;
+}
+
+void FramebufferPool_Wipeout(FramebufferPool* This)
+{
+	while (This->EntriesCount > 0)
+	{
+		FramebufferPool_RemoveEntry(This, This->EntriesCount - 1);
+	}
+	
+	free(This->Entries);
+	This->Entries = NULL;
+	This->EntriesMax = 0;
+}
+
+void FramebufferPool_Init(FramebufferPool* This, unsigned int MaxIdleFrames)
+{
+	This->EntriesCount = 0;
+	This->EntriesMax = 8;
+	This->Frame = 0;
+	This->MaxIdleFrames = MaxIdleFrames;
+	
+	This->Entries = malloc(sizeof(FramebufferPoolEntry*) * This->EntriesMax);
+	
+	if (This->Entries == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
+}
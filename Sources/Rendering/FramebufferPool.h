@@ -0,0 +1,86 @@
+/*
+ * FramebufferPool.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef FRAMEBUFFER_POOL_H
+#define FRAMEBUFFER_POOL_H
+
+#include "FramebufferObject.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Hands out transient FramebufferObject matching a size
+// and a descriptor. A target released back to
+// the pool is reused by the next matching request, and
+// destroyed once it stayed unused for MaxIdleFrames.
+//
+// Targets are allocated with some headroom, rounded to
+// FRAMEBUFFER_POOL_BUCKET_STEP, and any free target up to
+// about twice the requested size is handed out with its
+// used size set to the request. Dragging a paned handle
+// thus reallocates once in a while instead of every frame.
+// An oversized target is shrunk back to the bucket of the
+// largest size it served in a frame, once that largest size
+// stayed the same for SETTLE_FRAMES frames. A target shared
+// by views of different sizes thus settles as well.
+//
+// Frames are only counted when something gets rendered, an
+// idle frontend ages nothing. Trim() is there for a layout
+// change, after which some targets will not be asked again.
+
+#define FRAMEBUFFER_POOL_DEFAULT_MAX_IDLE_FRAMES 60
+#define FRAMEBUFFER_POOL_BUCKET_STEP 64
+#define FRAMEBUFFER_POOL_SETTLE_FRAMES 30
+
+typedef struct FramebufferPoolEntry
+{
+	FramebufferObject Fbo;
+	int InUse;
+	unsigned int LastUsedFrame;
+	int FrameWidth;
+	int FrameHeight;
+	int RequestWidth;
+	int RequestHeight;
+	unsigned int RequestSinceFrame;
+} FramebufferPoolEntry;
+
+typedef struct FramebufferPool FramebufferPool;
+
+struct FramebufferPool
+{
+	FramebufferPoolEntry** Entries;
+	int EntriesCount;
+	int EntriesMax;
+	unsigned int Frame;
+	unsigned int MaxIdleFrames;
+};
+
+FramebufferObject* FramebufferPool_Acquire(FramebufferPool*, int, int, const FramebufferObjectDescriptor*);
+void FramebufferPool_Release(FramebufferPool*, FramebufferObject*);
+void FramebufferPool_EndFrame(FramebufferPool*);
+void FramebufferPool_Trim(FramebufferPool*);
+int FramebufferPool_GetCount(FramebufferPool*);
+size_t FramebufferPool_GetBytesUsed(FramebufferPool*);
+
+void FramebufferPool_Wipeout(FramebufferPool*);
+void FramebufferPool_Init(FramebufferPool*, unsigned int);
+
+#endif
@@ -25,6 +25,7 @@
  
 #include "Radian.h" 
 #include "RenderingEngine.h"
+#include "Trace.h"
 
 static void openglDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam) 
 {
@@ -50,14 +51,158 @@ static void openglDebugCallback(GLenum source, GLenum type, GLuint id, GLenum se
     }
 }
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A shader still compiling is skipped, it gets the grid infos
+// from RenderingEngine_PollShaders() once it is ready.
+
 void RenderingEngine_RefreshGridInfos(RenderingEngine* engine)
 {
-	engine->ShaderFiniteGrid.Bind(&engine->ShaderFiniteGrid);
-	engine->ShaderFiniteGrid.SendGridSize(&engine->ShaderFiniteGrid, engine->GridSize);
-	engine->ShaderFiniteGrid.SendGridCellSize(&engine->ShaderFiniteGrid, engine->GridCellSize);
-	engine->ShaderFiniteGrid.SendGridColorThin(&engine->ShaderFiniteGrid, &engine->GridColorThin);
-	engine->ShaderFiniteGrid.SendGridColorThick(&engine->ShaderFiniteGrid, &engine->GridColorThick);
-	engine->ShaderFiniteGrid.Unbind(&engine->ShaderFiniteGrid);
+	FiniteGridShader* Grid = &engine->ShaderFiniteGrid;
+	
+	if (Grid->IsReady(Grid))
+	{
+		for (int PlaneID = 0; PlaneID < FINITE_GRID_PLANE_MAX; PlaneID++)
+		{
+			Grid->Bind(Grid, PlaneID);
+			Grid->SendGridSize(Grid, engine->GridSize);
+			Grid->SendGridCellSize(Grid, engine->GridCellSize);
+			Grid->SendGridColorThin(Grid, &engine->GridColorThin);
+			Grid->SendGridColorThick(Grid, &engine->GridColorThick);
+			Grid->Unbind(Grid);
+		}
+	}
+	
+	FiniteGridMultiViewShader* MultiView = &engine->ShaderFiniteGridMultiView;
+	
+	if (MultiView->IsReady(MultiView))
+	{
+		MultiView->Bind(MultiView);
+		MultiView->SendGridSize(MultiView, engine->GridSize);
+		MultiView->SendGridCellSize(MultiView, engine->GridCellSize);
+		MultiView->SendGridColorThin(MultiView, &engine->GridColorThin);
+		MultiView->SendGridColorThick(MultiView, &engine->GridColorThick);
+		MultiView->Unbind(MultiView);
+	}
+}
+
+int RenderingEngine_HasPendingShaders(RenderingEngine* engine)
+{
+	return engine->ShaderFiniteGrid.Variants.HasPending(&engine->ShaderFiniteGrid.Variants) || engine->ShaderFiniteGridMultiView.ShaderProg.IsPending;
+}
+
+int RenderingEngine_IsAnimating(RenderingEngine* engine)
+{
+	for (ViewName Index = VIEW_PERSPECTIVE; Index < VIEW_MAX; Index++)
+	{
+		if (engine->Cameras[Index].Animation != CAMERA_CONTROL_ANIMATION_NONE)
+		{
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// To be called when a file of SHADER_PATH changed, typically
+// from a file monitor. Nothing is compiled here, the GL
+// context may not even be current, the shaders using the file
+// are rebuilt by the next render. Returns TRUE if one does.
+
+int RenderingEngine_ShaderSourceChanged(RenderingEngine* engine, const char* FileName)
+{
+	ShaderVariants* Grid = &engine->ShaderFiniteGrid.Variants;
+	ShaderProgram* MultiView = &engine->ShaderFiniteGridMultiView.ShaderProg;
+	int OutdatedShaders = 0;
+	
+	if (Grid->UsesSourceFile(Grid, FileName))
+	{
+		OutdatedShaders |= RENDERING_ENGINE_SHADER_FINITE_GRID;
+	}
+	
+	if (MultiView->UsesSourceFile(MultiView, FileName))
+	{
+		OutdatedShaders |= RENDERING_ENGINE_SHADER_FINITE_GRID_MULTI_VIEW;
+	}
+	
+	engine->OutdatedShaders |= OutdatedShaders;
+	
+	return OutdatedShaders != 0;
+}
+
+static void RenderingEngine_PollShaders(RenderingEngine* engine)
+{
+	int IsRefreshNeeded = RenderingEngine_HasPendingShaders(engine);
+	
+	if (engine->OutdatedShaders & RENDERING_ENGINE_SHADER_FINITE_GRID)
+	{
+		IsRefreshNeeded |= engine->ShaderFiniteGrid.Reload(&engine->ShaderFiniteGrid);
+	}
+	
+	if (engine->OutdatedShaders & RENDERING_ENGINE_SHADER_FINITE_GRID_MULTI_VIEW)
+	{
+		IsRefreshNeeded |= engine->ShaderFiniteGridMultiView.Reload(&engine->ShaderFiniteGridMultiView);
+	}
+	
+	engine->OutdatedShaders = 0;
+	
+	if (IsRefreshNeeded)
+	{
+		RenderingEngine_RefreshGridInfos(engine);
+	}
+}
+
+static int RenderingEngine_PlaneID(ViewName Name)
+{
+	if (Name == VIEW_FRONT || Name == VIEW_BACK)
+	{
+		return 1;
+	}
+	else if (Name == VIEW_RIGHT || Name == VIEW_LEFT)
+	{
+		return 2;
+	}
+	
+	return 0;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The grid program must be bound. Instances is 1 for a single
+// view and the view count for the multi-view program.
+
+static void RenderingEngine_DrawGrid(RenderingEngine* engine, GLsizei Instances)
+{
+	// Disable culling for grid
+	glDisable(GL_CULL_FACE);
+
+	// Enable depth testing and offset
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(1.0, 1.0);
+	
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBindVertexArray(engine->EmptyVao);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, Instances);
+	glBindVertexArray(0); 
+	glDisable(GL_BLEND);
+	
+	// Restore state
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glEnable(GL_CULL_FACE); // Re-enable for 3D models
+	glCullFace(GL_BACK);
+}
+
+static void RenderingEngine_UpdateCamera(RenderingEngine* engine, ViewName Name)
+{
+	CameraControl* Camera = &engine->Cameras[Name];
+	
+	Camera->ComputeMatrices(Camera);
+	
+	CameraUniformBuffer_SetCamera(&engine->CameraUbo, Name, &engine->ProjectionMatrix[Name], &engine->InvProjectionMatrix[Name],
+								  Camera->GetViewMatrix(Camera), Camera->GetInvViewMatrix(Camera),
+								  Camera->ViewWidth, Camera->ViewHeight, RenderingEngine_PlaneID(Name));
 }
 
 void RenderingEngine_RefreshAfterResize(RenderingEngine* engine, ViewViewport ViewID, int Width, int Height)
@@ -67,10 +212,6 @@ void RenderingEngine_RefreshAfterResize(RenderingEngine* engine, ViewViewport Vi
 		engine->Widths[ViewID] = Width;
 		engine->Heights[ViewID] = Height;
 		
-		FramebufferObject_Rebuilt(&engine->MultisampleFbo[ViewID], Width, Height);
-		FramebufferObject_Rebuilt(&engine->ColorOutputFbo[ViewID], Width, Height);
-		FramebufferObject_Rebuilt(&engine->BrightOutputFbo[ViewID], Width, Height);
-		
 		ViewName Name = engine->ViewportViewNameMapping[ViewID];
 		
 		engine->Cameras[Name].SetViewWidth(&engine->Cameras[Name], Width);
@@ -79,7 +220,15 @@ void RenderingEngine_RefreshAfterResize(RenderingEngine* engine, ViewViewport Vi
 		float AspectRatio = ((float) Width) / ((float) Height);
 		
 		Mat44f_Perspective(&engine->ProjectionMatrix[Name], Radian(FIELD_OF_VIEW), AspectRatio, NEAR_PLANE, FAR_PLANE);
-		Mat44f_Inverse(&engine->ProjectionMatrix[Name], &engine->InvProjectionMatrix[Name]);
+		Mat44f_InversePerspective(&engine->InvProjectionMatrix[Name], Radian(FIELD_OF_VIEW), AspectRatio, NEAR_PLANE, FAR_PLANE);
+		
+		// Resized after the frame upload, only this camera is sent again.
+		
+		if (engine->CamerasUploaded == TRUE)
+		{
+			RenderingEngine_UpdateCamera(engine, Name);
+			CameraUniformBuffer_UploadCamera(&engine->CameraUbo, Name);
+		}
 	}
 
 }
@@ -97,99 +246,290 @@ void RenderingEngine_SwitchMode(RenderingEngine* engine, ViewMode Mode, ViewView
 		engine->Heights[VIEW_VIEWPORT_E] = 0;
 	}
 	
+	// The targets of the previous layout go at the end of the next frame
+	// rendered, an idle frontend renders none to age them out.
+	
+	if (engine->Mode != Mode)
+	{
+		engine->TrimTargets = TRUE;
+	}
+	
 	engine->Mode = Mode;
 	
 }
 
-void RenderingEngine_Render(RenderingEngine* engine, int ViewportID, GLuint FinalFbo, int Width, int Height)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// To be called by a post-processing stage needing the bright
+// and HDR color targets. The targets of the previous setting
+// are left in the pool and reclaimed once they go stale.
+
+void RenderingEngine_SetPostProcessing(RenderingEngine* engine, int PostProcessing)
 {
-	RenderingEngine_RefreshAfterResize(engine, (ViewViewport) ViewportID, Width, Height);
+	engine->PostProcessing = PostProcessing;
+}
+
+void RenderingEngine_SetSinglePass(RenderingEngine* engine, int SinglePass)
+{
+	engine->SinglePass = SinglePass;
+}
+
+// Once per frame, the views rendered after the first one only bind their range.
+
+static void RenderingEngine_UpdateCameras(RenderingEngine* engine)
+{
+	if (engine->CamerasUploaded == TRUE)
+	{
+		return;
+	}
+	
+	for (ViewName Name = 0; Name < VIEW_MAX; Name++)
+	{
+		RenderingEngine_UpdateCamera(engine, Name);
+	}
+	
+	CameraUniformBuffer_Upload(&engine->CameraUbo);
+	engine->CamerasUploaded = TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Renders one view, its size must have been refreshed and the
+// cameras uploaded already.
+
+static void RenderingEngine_RenderView(RenderingEngine* engine, int ViewportID, GLuint FinalFbo, int Width, int Height)
+{
+	FramebufferObjectDescriptor SceneDescriptor;
+	FramebufferObjectType SceneType = engine->PostProcessing == TRUE ? FBO_TYPE_SCENE_3D : FBO_TYPE_SCENE_3D_NO_BRIGHT;
+	
+	FramebufferObjectDescriptor_Init(&SceneDescriptor, SceneType, engine->Samples);
+	SceneDescriptor.ColorFormat = engine->ColorFormat;
+	
+	FramebufferObject* MultisampleFbo = FramebufferPool_Acquire(&engine->TargetPool, Width, Height, &SceneDescriptor);
+	
+	if (MultisampleFbo == NULL)
+	{
+		return;
+	}
 	
-	FramebufferObject_Bind(&engine->MultisampleFbo[ViewportID]);
+	FramebufferObject_Bind(MultisampleFbo);
 	
 	glClearColor(0.30f, 0.30f, 0.30f, 1.0f); 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	
-	engine->ShaderFiniteGrid.Bind(&engine->ShaderFiniteGrid);
-
 	ViewName ViewID = engine->ViewportViewNameMapping[ViewportID];
 	
-	if (ViewID == VIEW_PERSPECTIVE || ViewID == VIEW_TOP)
+	CameraUniformBuffer_BindCamera(&engine->CameraUbo, ViewID);
+	
+	// Until its program is linked the view only gets the clear color.
+	
+	if (engine->ShaderFiniteGrid.IsReady(&engine->ShaderFiniteGrid))
 	{
-		engine->ShaderFiniteGrid.SendPlaneID(&engine->ShaderFiniteGrid, 0);
+		engine->ShaderFiniteGrid.Bind(&engine->ShaderFiniteGrid, RenderingEngine_PlaneID(ViewID));
+		RenderingEngine_DrawGrid(engine, 1);
+		engine->ShaderFiniteGrid.Unbind(&engine->ShaderFiniteGrid);
 	}
-	else if (ViewID == VIEW_FRONT || ViewID == VIEW_BACK)
+	
+	// Depth is dead once the scene is drawn, only the colors get resolved.
+	
+	FramebufferObject_Invalidate(MultisampleFbo, FBO_KEEP_DEPTH & ~MultisampleFbo->KeepPolicy);
+	FramebufferObject_Unbind(MultisampleFbo);
+	
+	if (engine->PostProcessing == FALSE)
 	{
-		engine->ShaderFiniteGrid.SendPlaneID(&engine->ShaderFiniteGrid, 1);
+		// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+		// Nothing to post-process, the multisample buffer is resolved straight
+		// into the FinalFbo, saving two full screen copies.
+		
+		FramebufferObject_ResolveToExternal(MultisampleFbo, FinalFbo, Width, Height, GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
+		FramebufferObject_InvalidateDead(MultisampleFbo);
+		FramebufferPool_Release(&engine->TargetPool, MultisampleFbo);
+		return;
 	}
-	else if (ViewID == VIEW_RIGHT || ViewID == VIEW_LEFT)
+	
+	// The outputs hold no more precision than the scene they are resolved from.
+	
+	FramebufferObjectDescriptor OutputDescriptor;
+	
+	FramebufferObjectDescriptor_Init(&OutputDescriptor, FBO_TYPE_COLOR_OUTPUT, 1);
+	OutputDescriptor.ColorFormat = engine->ColorFormat;
+	
+	FramebufferObject* ColorOutputFbo = FramebufferPool_Acquire(&engine->TargetPool, Width, Height, &OutputDescriptor);
+	FramebufferObject* BrightOutputFbo = FramebufferPool_Acquire(&engine->TargetPool, Width, Height, &OutputDescriptor);
+	
+	if (ColorOutputFbo == NULL || BrightOutputFbo == NULL)
 	{
-		engine->ShaderFiniteGrid.SendPlaneID(&engine->ShaderFiniteGrid, 2);
+		if (ColorOutputFbo != NULL)
+		{
+			FramebufferPool_Release(&engine->TargetPool, ColorOutputFbo);
+		}
+		
+		FramebufferPool_Release(&engine->TargetPool, MultisampleFbo);
+		return;
 	}
 	
-	engine->ShaderFiniteGrid.SendProjectionMatrix(&engine->ShaderFiniteGrid, &engine->ProjectionMatrix[ViewID]);
-	engine->Cameras[ViewID].ComputeMatrices(&engine->Cameras[ViewID]);
+	FramebufferObject_ResolveToFbo(MultisampleFbo, ColorOutputFbo, GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
+	FramebufferObject_ResolveToFbo(MultisampleFbo, BrightOutputFbo, GL_COLOR_ATTACHMENT1, GL_COLOR_BUFFER_BIT);
+	FramebufferObject_InvalidateDead(MultisampleFbo);
+	FramebufferPool_Release(&engine->TargetPool, MultisampleFbo);
 	
+	// Pooled outputs, nothing reads them once this view is done.
 	
-	/*if (ViewID == VIEW_PERSPECTIVE)
-	{
-		Mat44f* ViewMatrix = &engine->ProjectionMatrix[ViewID];
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e11, ViewMatrix->e12, ViewMatrix->e13, ViewMatrix->e14);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e21, ViewMatrix->e22, ViewMatrix->e23, ViewMatrix->e24);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e31, ViewMatrix->e32, ViewMatrix->e33, ViewMatrix->e34);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e41, ViewMatrix->e42, ViewMatrix->e43, ViewMatrix->e44);
-		printf(" \n");
-	}*/
+	FramebufferObject_SetKeepPolicy(ColorOutputFbo, FBO_KEEP_NONE);
+	FramebufferObject_SetKeepPolicy(BrightOutputFbo, FBO_KEEP_NONE);
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// Do some post-processing effect here
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// Finally we blit the framebuffer from our rendering engine to the FinalFbo.
+	// Rendering directly to it don't work and I don't understand why.
+	
+	FramebufferObject_ResolveToExternal(ColorOutputFbo, FinalFbo, Width, Height, GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
 	
+	FramebufferObject_InvalidateDead(ColorOutputFbo);
+	FramebufferObject_InvalidateDead(BrightOutputFbo);
+	
+	FramebufferPool_Release(&engine->TargetPool, ColorOutputFbo);
+	FramebufferPool_Release(&engine->TargetPool, BrightOutputFbo);
+}
+
+void RenderingEngine_Render(RenderingEngine* engine, int ViewportID, GLuint FinalFbo, int Width, int Height)
+{
+	TRACE_SCOPE("RenderingEngine_Render");
 	
-	Mat44f* ViewMatrix = engine->Cameras[ViewID].GetViewMatrix(&engine->Cameras[ViewID]);
+	RenderingEngine_PollShaders(engine);
+	RenderingEngine_RefreshAfterResize(engine, (ViewViewport) ViewportID, Width, Height);
+	RenderingEngine_UpdateCameras(engine);
+	RenderingEngine_RenderView(engine, ViewportID, FinalFbo, Width, Height);
+}
+
+static int RenderingEngine_CanRenderSinglePass(RenderingEngine* engine, int Count, int AtlasWidth)
+{
+	if (engine->SinglePass == FALSE || engine->PostProcessing == TRUE || Count < 2 || Count > MULTI_VIEW_MAX)
+	{
+		return FALSE;
+	}
 	
-	/*if (ViewID == VIEW_PERSPECTIVE)
+	if (engine->ShaderFiniteGridMultiView.IsReady(&engine->ShaderFiniteGridMultiView) == FALSE)
 	{
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e11, ViewMatrix->e12, ViewMatrix->e13, ViewMatrix->e14);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e21, ViewMatrix->e22, ViewMatrix->e23, ViewMatrix->e24);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e31, ViewMatrix->e32, ViewMatrix->e33, ViewMatrix->e34);
-		printf("[%0.3f, %0.3f, %0.3f, %0.3f]\n", ViewMatrix->e41, ViewMatrix->e42, ViewMatrix->e43, ViewMatrix->e44);
-	}*/
+		return FALSE;
+	}
 	
-	engine->ShaderFiniteGrid.SendViewMatrix(&engine->ShaderFiniteGrid, ViewMatrix);
+	// The pool over-allocates, keep some room for it.
 	
-	// Disable culling for grid
-	glDisable(GL_CULL_FACE);
+	return AtlasWidth + AtlasWidth / 4 + FRAMEBUFFER_POOL_BUCKET_STEP <= engine->MaxRenderbufferSize;
+}
 
-	// Enable depth testing and offset
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
-	glEnable(GL_POLYGON_OFFSET_FILL);
-	glPolygonOffset(1.0, 1.0);
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Renders Count views at once. The views are laid out left to
+// right in one multisample atlas, each one with its own entry
+// of the viewport array, then every region is resolved into
+// its FinalFbo.
+
+void RenderingEngine_RenderViews(RenderingEngine* engine, int Count, const int* ViewportIDs, const GLuint* FinalFbos, const int* Widths, const int* Heights)
+{
+	TRACE_SCOPE("RenderingEngine_RenderViews");
 	
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glBindVertexArray(engine->EmptyVao);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0); 
-	glDisable(GL_BLEND);
+	int AtlasWidth = 0;
+	int AtlasHeight = 0;
 	
-	// Restore state
-	glDisable(GL_POLYGON_OFFSET_FILL);
-	glEnable(GL_CULL_FACE); // Re-enable for 3D models
-	glCullFace(GL_BACK);
+	for (int Index = 0; Index < Count; Index++)
+	{
+		AtlasWidth += Widths[Index];
+		AtlasHeight = Heights[Index] > AtlasHeight ? Heights[Index] : AtlasHeight;
+	}
+	
+	RenderingEngine_PollShaders(engine);
 	
-	engine->ShaderFiniteGrid.Unbind(&engine->ShaderFiniteGrid);
+	// Every view size first, the projections depend on them.
 	
-	FramebufferObject_Unbind(&engine->MultisampleFbo[ViewportID]);
+	for (int Index = 0; Index < Count; Index++)
+	{
+		RenderingEngine_RefreshAfterResize(engine, (ViewViewport) ViewportIDs[Index], Widths[Index], Heights[Index]);
+	}
 	
-	FramebufferObject_ResolveToFbo(&engine->MultisampleFbo[ViewportID], &engine->ColorOutputFbo[ViewportID], GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
-	FramebufferObject_ResolveToFbo(&engine->MultisampleFbo[ViewportID], &engine->BrightOutputFbo[ViewportID], GL_COLOR_ATTACHMENT1, GL_COLOR_BUFFER_BIT);
+	RenderingEngine_UpdateCameras(engine);
 	
-	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-	// Do some post-processing effect here
+	FramebufferObject* AtlasFbo = NULL;
 	
-	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-	// Finally we blit the framebuffer from our rendering engine to the FinalFbo.
-	// Rendering directly to it don't work and I don't understand why.
+	if (RenderingEngine_CanRenderSinglePass(engine, Count, AtlasWidth))
+	{
+		FramebufferObjectDescriptor AtlasDescriptor;
+		
+		FramebufferObjectDescriptor_Init(&AtlasDescriptor, FBO_TYPE_SCENE_3D_NO_BRIGHT, engine->Samples);
+		AtlasDescriptor.ColorFormat = engine->ColorFormat;
+		
+		AtlasFbo = FramebufferPool_Acquire(&engine->TargetPool, AtlasWidth, AtlasHeight, &AtlasDescriptor);
+	}
+	
+	if (AtlasFbo == NULL)
+	{
+		for (int Index = 0; Index < Count; Index++)
+		{
+			RenderingEngine_RenderView(engine, ViewportIDs[Index], FinalFbos[Index], Widths[Index], Heights[Index]);
+		}
+		
+		return;
+	}
+	
+	GLint ViewNames[MULTI_VIEW_MAX];
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		ViewNames[Index] = engine->ViewportViewNameMapping[ViewportIDs[Index]];
+	}
+	
+	CameraUniformBuffer_BindAll(&engine->CameraUbo);
+	
+	FramebufferObject_Bind(AtlasFbo);
+	
+	glClearColor(0.30f, 0.30f, 0.30f, 1.0f); 
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	
+	// After the Bind, its glViewport() resets every viewport of the array.
+	
+	for (int Index = 0, X = 0; Index < Count; Index++)
+	{
+		glViewportIndexedf(Index, (float) X, 0.0f, (float) Widths[Index], (float) Heights[Index]);
+		X += Widths[Index];
+	}
+	
+	engine->ShaderFiniteGridMultiView.Bind(&engine->ShaderFiniteGridMultiView);
+	engine->ShaderFiniteGridMultiView.SendViewNames(&engine->ShaderFiniteGridMultiView, ViewNames, Count);
+	RenderingEngine_DrawGrid(engine, Count);
+	engine->ShaderFiniteGridMultiView.Unbind(&engine->ShaderFiniteGridMultiView);
+	
+	FramebufferObject_Invalidate(AtlasFbo, FBO_KEEP_DEPTH & ~AtlasFbo->KeepPolicy);
+	FramebufferObject_Unbind(AtlasFbo);
+	
+	for (int Index = 0, X = 0; Index < Count; Index++)
+	{
+		FramebufferObject_ResolveRegionToExternal(AtlasFbo, X, 0, FinalFbos[Index], Widths[Index], Heights[Index], GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
+		X += Widths[Index];
+	}
 	
-	FramebufferObject_ResolveToExternal(&engine->ColorOutputFbo[ViewportID], FinalFbo, Width, Height, GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT);
+	FramebufferObject_InvalidateDead(AtlasFbo);
+	FramebufferPool_Release(&engine->TargetPool, AtlasFbo);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// To be called once every view of a frame got rendered. The
+// targets nobody asked for lately, like the ones of the four
+// small views while a view is maximized, are destroyed here.
+
+void RenderingEngine_EndFrame(RenderingEngine* engine)
+{
+	if (engine->IsInitialized == TRUE)
+	{
+		if (engine->TrimTargets == TRUE)
+		{
+			FramebufferPool_Trim(&engine->TargetPool);
+			engine->TrimTargets = FALSE;
+		}
+		
+		FramebufferPool_EndFrame(&engine->TargetPool);
+	}
+	
+	engine->CamerasUploaded = FALSE;
 }
 
 void RenderingEngine_Initialize(RenderingEngine* engine)
@@ -209,8 +549,14 @@ void RenderingEngine_Initialize(RenderingEngine* engine)
 		
 		glGenVertexArrays(1, &engine->EmptyVao);
 		
-		engine->ShaderFiniteGrid.Initialize(&engine->ShaderFiniteGrid, "res/shaders/");
-		RenderingEngine_RefreshGridInfos(engine);
+		// Both programs compile in the background, see RenderingEngine_PollShaders().
+		
+		engine->ShaderFiniteGrid.Initialize(&engine->ShaderFiniteGrid, SHADER_PATH);
+		engine->ShaderFiniteGridMultiView.Initialize(&engine->ShaderFiniteGridMultiView, SHADER_PATH);
+		
+		glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &engine->MaxRenderbufferSize);
+		
+		CameraUniformBuffer_Initialize(&engine->CameraUbo);
 		
 		for (ViewViewport ViewportID = 0; ViewportID < VIEW_VIEWPORT_MAX; ViewportID++)
 		{
@@ -244,11 +590,9 @@ void RenderingEngine_Initialize(RenderingEngine* engine)
 			{
 				engine->Cameras[Name].RestoreToLeftView(&engine->Cameras[Name]);
 			}
-			
-			FramebufferObject_Init(&engine->MultisampleFbo[ViewportID], 400, 300, FBO_TYPE_SCENE_3D, TRUE);
-			FramebufferObject_Init(&engine->ColorOutputFbo[ViewportID], 400, 300, FBO_TYPE_COLOR_OUTPUT, FALSE);
-			FramebufferObject_Init(&engine->BrightOutputFbo[ViewportID], 400, 300, FBO_TYPE_COLOR_OUTPUT, FALSE);
 		}
+		
+		FramebufferPool_Init(&engine->TargetPool, FRAMEBUFFER_POOL_DEFAULT_MAX_IDLE_FRAMES);
 	
 		engine->IsInitialized = TRUE;
 	}
@@ -260,28 +604,33 @@ void RenderingEngine_Wipeout(RenderingEngine* engine)
 	{
 		glDeleteVertexArrays(1, &engine->EmptyVao);
 		
-		for (ViewViewport ViewportID = 0; ViewportID < VIEW_VIEWPORT_MAX; ViewportID++)
-		{
-			FramebufferObject_Wipeout(&engine->MultisampleFbo[ViewportID]);
-			FramebufferObject_Wipeout(&engine->ColorOutputFbo[ViewportID]);
-			FramebufferObject_Wipeout(&engine->BrightOutputFbo[ViewportID]);
-		}
+		FramebufferPool_Wipeout(&engine->TargetPool);
+		
+		CameraUniformBuffer_Wipeout(&engine->CameraUbo);
 		
 		engine->ShaderFiniteGrid.Wipeout(&engine->ShaderFiniteGrid);
+		engine->ShaderFiniteGridMultiView.Wipeout(&engine->ShaderFiniteGridMultiView);
 		
 		engine->IsInitialized = FALSE;
 	}
+	
+	engine->CamerasUploaded = FALSE;
 }
 
 void RenderingEngine_Init(RenderingEngine* engine)
 {
 	engine->IsInitialized = FALSE;
+	engine->CamerasUploaded = FALSE;
+	engine->TrimTargets = FALSE;
 	engine->GridSize = 100.0f;
 	engine->GridCellSize = 1.0f;
 	
 	engine->GridColorThin = (Col4f){0.5f, 0.5f, 0.5f, 1.0f};
 	engine->GridColorThick = (Col4f){1.0f, 1.0f, 1.0f, 1.0f};
 	engine->Mode = VIEW_MODE_MULTIPLE_VIEWS;
+	engine->PostProcessing = FALSE;
+	engine->Samples = 4;
+	engine->ColorFormat = FBO_COLOR_FORMAT_RGBA8;
 	
 	engine->ViewportViewNameMapping[VIEW_VIEWPORT_A] = VIEW_TOP;
 	engine->ViewportViewNameMapping[VIEW_VIEWPORT_B] = VIEW_PERSPECTIVE;
@@ -292,6 +641,12 @@ void RenderingEngine_Init(RenderingEngine* engine)
 	CameraControlSettings_Init(&engine->CamCtrlSettings);
 	
 	FiniteGridShader_Init(&engine->ShaderFiniteGrid);
+	FiniteGridMultiViewShader_Init(&engine->ShaderFiniteGridMultiView);
+	
+	engine->OutdatedShaders = 0;
+	engine->SinglePass = TRUE;
+	CameraUniformBuffer_Init(&engine->CameraUbo, VIEW_MAX);
+	engine->MaxRenderbufferSize = 0;
 	
 	for (int i = 0; i < VIEW_VIEWPORT_MAX; i++)
 	{
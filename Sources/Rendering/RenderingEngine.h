@@ -33,12 +33,20 @@
 #include "CameraControl.h"
 
 #include "FramebufferObject.h"
+#include "FramebufferPool.h"
 #include "FiniteGridShader.h"
+#include "FiniteGridMultiViewShader.h"
+#include "CameraUniformBuffer.h"
 
 #define FIELD_OF_VIEW 45.0f
 #define NEAR_PLANE 0.1f
 #define FAR_PLANE 1000.0f
 
+#define SHADER_PATH "res/shaders/"
+
+#define RENDERING_ENGINE_SHADER_FINITE_GRID 0x01
+#define RENDERING_ENGINE_SHADER_FINITE_GRID_MULTI_VIEW 0x02
+
 typedef enum
 {
 	VIEW_MODE_MULTIPLE_VIEWS,
@@ -80,9 +88,22 @@ struct RenderingEngine
 	
 	ViewMode Mode;
 	ViewName ViewportViewNameMapping[VIEW_VIEWPORT_MAX];
-	FramebufferObject MultisampleFbo[VIEW_VIEWPORT_MAX];
-	FramebufferObject ColorOutputFbo[VIEW_VIEWPORT_MAX];
-	FramebufferObject BrightOutputFbo[VIEW_VIEWPORT_MAX];
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// The render targets are borrowed from the TargetPool for
+	// the duration of a single Render call, so views sharing
+	// the same size share the same targets. The color and the
+	// bright targets are only requested while PostProcessing
+	// is TRUE. Otherwise the multisample target is resolved
+	// straight into the FinalFbo. Samples and ColorFormat
+	// describe the scene targets, an HDR post-processing
+	// stage would switch ColorFormat to a float format.
+	
+	int PostProcessing;
+	int Samples;
+	FramebufferObjectColorFormat ColorFormat;
+	FramebufferPool TargetPool;
+	int TrimTargets;
 	int Widths[VIEW_VIEWPORT_MAX];
 	int Heights[VIEW_VIEWPORT_MAX];
 	
@@ -90,15 +111,53 @@ struct RenderingEngine
 	Mat44f InvProjectionMatrix[VIEW_MAX];
 	CameraControl Cameras[VIEW_MAX];
 	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// The matrices of every camera, indexed by ViewName and
+	// uploaded by the first Render or RenderViews call of a
+	// frame, CamerasUploaded being cleared by EndFrame. Every
+	// shader gets its camera from there rather than from
+	// plain uniforms.
+	
+	CameraUniformBuffer CameraUbo;
+	int CamerasUploaded;
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// The shaders are only submitted by Initialize and get
+	// polled at every render. Views render the clear color
+	// until the grid program is ready, the frontend keeps
+	// rendering while RenderingEngine_HasPendingShaders().
+	// OutdatedShaders flags the ones to rebuild from their
+	// edited sources at the next render.
+	
+	int OutdatedShaders;
 	FiniteGridShader ShaderFiniteGrid;
 	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// With SinglePass TRUE, RenderingEngine_RenderViews draws
+	// all the views side by side in one atlas target with a
+	// single instanced draw, the per view cameras being picked
+	// from the CameraUbo. It silently falls back to one Render call
+	// per view when the driver lacks the needed extension,
+	// when post-processing or when the atlas would be too wide.
+	
+	int SinglePass;
+	FiniteGridMultiViewShader ShaderFiniteGridMultiView;
+	GLint MaxRenderbufferSize;
+	
 	GLuint EmptyVao;
 	
 };
 
 void RenderingEngine_ViewportViewNameMapping(RenderingEngine*, ViewViewport, ViewName);
 void RenderingEngine_SwitchMode(RenderingEngine*, ViewMode, ViewViewport);
+void RenderingEngine_SetPostProcessing(RenderingEngine*, int);
+void RenderingEngine_SetSinglePass(RenderingEngine*, int);
 void RenderingEngine_Render(RenderingEngine*, int, GLuint, int, int);
+void RenderingEngine_RenderViews(RenderingEngine*, int, const int*, const GLuint*, const int*, const int*);
+void RenderingEngine_EndFrame(RenderingEngine*);
+int RenderingEngine_HasPendingShaders(RenderingEngine*);
+int RenderingEngine_IsAnimating(RenderingEngine*);
+int RenderingEngine_ShaderSourceChanged(RenderingEngine*, const char*);
 void RenderingEngine_Initialize(RenderingEngine*);
 void RenderingEngine_Wipeout(RenderingEngine*);
 void RenderingEngine_Init(RenderingEngine*);
@@ -0,0 +1,347 @@
+/*
+ * ShaderPreprocessor.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "ShaderPreprocessor.h"
+
+typedef struct ShaderPreprocessorBuffer
+{
+	char* Data;
+	size_t Length;
+	size_t Max;
+	
+} ShaderPreprocessorBuffer;
+
+static int ShaderPreprocessor_Append(ShaderPreprocessorBuffer* Buffer, const char* Text, size_t Length)
+{
+	if (Buffer->Length + Length + 1 > Buffer->Max)
+	{
+		size_t Max = Buffer->Max > 0 ? Buffer->Max * 2 : 4096;
+		
+		while (Buffer->Length + Length + 1 > Max)
+		{
+			Max *= 2;
+		}
+		
+		char* Data = realloc(Buffer->Data, Max);
+		
+		if (Data == NULL)
+		{
+			return FALSE;
+		}
+		
+		Buffer->Data = Data;
+		Buffer->Max = Max;
+	}
+	
+	memcpy(Buffer->Data + Buffer->Length, Text, Length);
+	Buffer->Length += Length;
+	Buffer->Data[Buffer->Length] = 0;
+	
+	return TRUE;
+}
+
+static int ShaderPreprocessor_AppendLine(ShaderPreprocessorBuffer* Buffer, int Line, int SourceNumber)
+{
+	char Directive[64];
+	int Length = snprintf(Directive, sizeof(Directive), "#line %d %d\n", Line, SourceNumber);
+	
+	return ShaderPreprocessor_Append(Buffer, Directive, Length);
+}
+
+static char* ShaderPreprocessor_LoadSource(const char* SourcePath, const char* FileName)
+{
+	char* PathFileName = (char*) malloc(sizeof(char) * (strlen(SourcePath) + strlen(FileName) + 1));
+	
+	if (PathFileName == NULL)
+	{
+		return NULL;
+	}
+	
+	strcpy(PathFileName, SourcePath);
+	strcat(PathFileName, FileName);
+	
+	FILE* Stream = fopen(PathFileName, "rb");
+	
+	if (Stream == NULL)
+	{
+		fprintf(stderr, "ShaderPreprocessor->LoadSource() : ReadFile failure ! : %s\n", PathFileName);
+		free(PathFileName);
+		return NULL;
+	}
+	
+	fseek(Stream, 0, SEEK_END);
+	long fsize = ftell(Stream);
+	fseek(Stream, 0, SEEK_SET);
+	
+	char* SourceCode = malloc(fsize + 1);
+	
+	if (SourceCode == NULL)
+	{
+		fprintf(stderr, "ShaderPreprocessor->LoadSource() : SourceCode allocation failure ! : %s\n", PathFileName);
+	}
+	else if (fread(SourceCode, 1, fsize, Stream) != (size_t) fsize)
+	{
+		fprintf(stderr, "ShaderPreprocessor->LoadSource() : ReadFile failure ! : %s\n", PathFileName);
+		free(SourceCode);
+		SourceCode = NULL;
+	}
+	else
+	{
+		SourceCode[fsize] = 0;
+	}
+	
+	fclose(Stream);
+	free(PathFileName);
+	
+	return SourceCode;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns the length of the directive keyword if the line,
+// leading blanks aside, starts with it, 0 otherwise.
+
+static size_t ShaderPreprocessor_MatchDirective(const char* Line, const char* LineEnd, const char* Directive)
+{
+	const char* Cursor = Line;
+	
+	while (Cursor < LineEnd && (*Cursor == ' ' || *Cursor == '\t'))
+	{
+		Cursor++;
+	}
+	
+	size_t Length = strlen(Directive);
+	
+	if ((size_t) (LineEnd - Cursor) < Length || strncmp(Cursor, Directive, Length) != 0)
+	{
+		return 0;
+	}
+	
+	return (Cursor - Line) + Length;
+}
+
+static int ShaderPreprocessor_HasVersion(const char* SourceCode)
+{
+	const char* Line = SourceCode;
+	
+	while (*Line != 0)
+	{
+		const char* LineEnd = strchr(Line, '\n');
+		
+		if (LineEnd == NULL)
+		{
+			LineEnd = Line + strlen(Line);
+		}
+		
+		if (ShaderPreprocessor_MatchDirective(Line, LineEnd, "#version") > 0)
+		{
+			return TRUE;
+		}
+		
+		Line = *LineEnd != 0 ? LineEnd + 1 : LineEnd;
+	}
+	
+	return FALSE;
+}
+
+static int ShaderPreprocessor_ProcessFile(ShaderPreprocessorBuffer* Buffer, const char* SourcePath, const char* FileName, const char* Defines, IntegerHashTable* Files, IntegerHashTable* Included, int Depth)
+{
+	if (Depth > SHADER_PREPROCESSOR_INCLUDE_DEPTH_MAX)
+	{
+		fprintf(stderr, "ShaderPreprocessor->Process() : Includes nested too deep ! : %s\n", FileName);
+		return FALSE;
+	}
+	
+	// Like #pragma once, a file already in this stage is skipped.
+	
+	if (Included->LookupBucket(Included, (char*) FileName))
+	{
+		return TRUE;
+	}
+	
+	int SourceNumber;
+	
+	if (Files->LookupBucket(Files, (char*) FileName))
+	{
+		SourceNumber = Files->GetBucketValue(Files);
+	}
+	else
+	{
+		SourceNumber = (int) Files->BucketsCount(Files);
+		Files->AddBucket(Files, (char*) FileName, SourceNumber);
+	}
+	
+	Included->AddBucket(Included, (char*) FileName, SourceNumber);
+	
+	char* SourceCode = ShaderPreprocessor_LoadSource(SourcePath, FileName);
+	
+	if (SourceCode == NULL)
+	{
+		return FALSE;
+	}
+	
+	int IsProcessed = TRUE;
+	int LineNumber = 1;
+	char* Line = SourceCode;
+	
+	// Without a #version the defines open the source, the driver picks its default version.
+	
+	if (Defines != NULL && ShaderPreprocessor_HasVersion(SourceCode) == FALSE)
+	{
+		IsProcessed = ShaderPreprocessor_Append(Buffer, Defines, strlen(Defines))
+			&& ShaderPreprocessor_AppendLine(Buffer, 1, SourceNumber);
+		
+		Defines = NULL;
+	}
+	
+	while (*Line != 0 && IsProcessed == TRUE)
+	{
+		char* LineEnd = strchr(Line, '\n');
+		char* NextLine = LineEnd != NULL ? LineEnd + 1 : Line + strlen(Line);
+		
+		if (LineEnd == NULL)
+		{
+			LineEnd = NextLine;
+		}
+		
+		size_t Length;
+		
+		if ((Length = ShaderPreprocessor_MatchDirective(Line, LineEnd, "#include")) > 0)
+		{
+			char* NameStart = memchr(Line + Length, '"', LineEnd - (Line + Length));
+			char* NameEnd = NameStart != NULL ? memchr(NameStart + 1, '"', LineEnd - (NameStart + 1)) : NULL;
+			
+			if (NameEnd == NULL)
+			{
+				fprintf(stderr, "ShaderPreprocessor->Process() : Malformed #include ! : %s(%d)\n", FileName, LineNumber);
+				IsProcessed = FALSE;
+			}
+			else
+			{
+				char* IncludeName = strndup(NameStart + 1, NameEnd - (NameStart + 1));
+				
+				IsProcessed = IncludeName != NULL
+					&& ShaderPreprocessor_AppendLine(Buffer, 1, Files->LookupBucket(Files, IncludeName) ? Files->GetBucketValue(Files) : (int) Files->BucketsCount(Files))
+					&& ShaderPreprocessor_ProcessFile(Buffer, SourcePath, IncludeName, NULL, Files, Included, Depth + 1)
+					&& ShaderPreprocessor_Append(Buffer, "\n", 1)
+					&& ShaderPreprocessor_AppendLine(Buffer, LineNumber + 1, SourceNumber);
+				
+				free(IncludeName);
+			}
+		}
+		else
+		{
+			IsProcessed = ShaderPreprocessor_Append(Buffer, Line, NextLine - Line);
+			
+			// The defines go right after the #version, nothing may come before it.
+			
+			if (IsProcessed && Defines != NULL && ShaderPreprocessor_MatchDirective(Line, LineEnd, "#version") > 0)
+			{
+				if (*LineEnd != '\n')
+				{
+					IsProcessed = ShaderPreprocessor_Append(Buffer, "\n", 1);
+				}
+				
+				IsProcessed = IsProcessed
+					&& ShaderPreprocessor_Append(Buffer, Defines, strlen(Defines))
+					&& ShaderPreprocessor_AppendLine(Buffer, LineNumber + 1, SourceNumber);
+				
+				Defines = NULL;
+			}
+		}
+		
+		Line = NextLine;
+		LineNumber++;
+	}
+	
+	free(SourceCode);
+	
+	return IsProcessed;
+}
+
+static int ShaderPreprocessor_CompareDefines(const void* A, const void* B)
+{
+	return strcmp(*(char* const*) A, *(char* const*) B);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns a "#define NAME VALUE\n" block, an empty string for
+// no define at all, or NULL on allocation failure.
+
+char* ShaderPreprocessor_FormatDefines(char** Defines, int Count)
+{
+	ShaderPreprocessorBuffer Buffer = {NULL, 0, 0};
+	char** Sorted = malloc(sizeof(char*) * (Count > 0 ? Count : 1));
+	int IsFormatted = Sorted != NULL && ShaderPreprocessor_Append(&Buffer, "", 0);
+	
+	if (IsFormatted)
+	{
+		memcpy(Sorted, Defines, sizeof(char*) * Count);
+		qsort(Sorted, Count, sizeof(char*), ShaderPreprocessor_CompareDefines);
+	}
+	
+	for (int Index = 0; Index < Count && IsFormatted; Index++)
+	{
+		IsFormatted = ShaderPreprocessor_Append(&Buffer, "#define ", 8)
+			&& ShaderPreprocessor_Append(&Buffer, Sorted[Index], strlen(Sorted[Index]))
+			&& ShaderPreprocessor_Append(&Buffer, "\n", 1);
+	}
+	
+	free(Sorted);
+	
+	if (IsFormatted == FALSE)
+	{
+		free(Buffer.Data);
+		return NULL;
+	}
+	
+	return Buffer.Data;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns the preprocessed source of a stage, to be freed by
+// the caller, or NULL if a file is missing or malformed.
+
+char* ShaderPreprocessor_Process(const char* SourcePath, const char* FileName, const char* Defines, IntegerHashTable* Files)
+{
+	ShaderPreprocessorBuffer Buffer = {NULL, 0, 0};
+	IntegerHashTable Included;
+	
+	IntegerHashTable_Init(&Included, 16);
+	
+	int IsProcessed = ShaderPreprocessor_ProcessFile(&Buffer, SourcePath, FileName, Defines != NULL && *Defines != 0 ? Defines : NULL, Files, &Included, 0);
+	
+	Included.Wipeout(&Included);
+	
+	if (IsProcessed == FALSE)
+	{
+		free(Buffer.Data);
+		return NULL;
+	}
+	
+	return Buffer.Data;
+}
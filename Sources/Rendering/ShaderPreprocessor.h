@@ -0,0 +1,47 @@
+/*
+ * ShaderPreprocessor.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include "IntegerHashTable.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Resolves #include "File" against the SourcePath, once per
+// stage, and injects the given #define block right after the
+// #version line, or at the very top of a source without one.
+// Every file gets its own source string number
+// in #line directives, so compile logs still point at the
+// right line. Files receives the name and the number of every
+// file read, which tells what a program depends on.
+//
+// The defines are a set, FormatDefines() sorts them so the
+// same set always gives the same block, usable as a key.
+// Each define is "NAME" or "NAME VALUE".
+
+#define SHADER_PREPROCESSOR_INCLUDE_DEPTH_MAX 16
+
+char* ShaderPreprocessor_FormatDefines(char**, int);
+char* ShaderPreprocessor_Process(const char*, const char*, const char*, IntegerHashTable*);
+
+#endif
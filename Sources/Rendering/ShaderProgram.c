@@ -24,49 +24,30 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 
+#include "ShaderPreprocessor.h"
 #include "ShaderProgram.h"
+#include "Trace.h"
 
-static char* ShaderProgram_LoadSource(char* PathFileName)
-{
-	FILE* Stream = fopen(PathFileName, "rb");
-	
-	if (Stream == NULL)
-	{
-		fprintf(stderr, "ShaderProgram->LoadSource() : ReadFile failure ! : %s", PathFileName);
-		
-		return NULL;
-	}
-	
-	fseek(Stream, 0, SEEK_END);
-	long fsize = ftell(Stream);
-	fseek(Stream, 0, SEEK_SET);
-
-	char* SourceCode = malloc(fsize + 1);
-	
-	if (SourceCode == NULL)
-	{
-		fprintf(stderr, "ShaderProgram->LoadSource() : SourceCode allocation failure ! : %s", PathFileName);
-		fclose(Stream);
-		return NULL;
-	}
-	
-	fread(SourceCode, fsize, 1, Stream);
-	SourceCode[fsize] = 0;
-	
-	fclose(Stream);
-	
-	return SourceCode;
-}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Only submits the compilation, its status is never queried
+// unless the program fails to link. Querying it right away
+// would serialize every compile on the calling thread.
 
-static GLuint ShaderProgram_CompileShader(char* FileName, char* SourceCode, GLint ShaderType)
+static GLuint ShaderProgram_CompileShader(char* SourceCode, GLenum ShaderType)
 {
 	GLuint ShaderID = glCreateShader(ShaderType);
 	const char* Code = SourceCode;
 	glShaderSource(ShaderID, 1, &Code, NULL);
 	glCompileShader(ShaderID);
 	
+	return ShaderID;
+}
+
+static void ShaderProgram_PrintShaderLog(char* FileName, GLuint ShaderID)
+{
 	GLint IsShaderCompiled;
 	glGetShaderiv(ShaderID, GL_COMPILE_STATUS, &IsShaderCompiled);
 	
@@ -77,349 +58,562 @@ static GLuint ShaderProgram_CompileShader(char* FileName, char* SourceCode, GLin
 		
 		char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
 		
-		glGetShaderInfoLog(ShaderID, MaxLength, &MaxLength, ErrorMessage);
-		fprintf(stderr, "ShaderProgram->CompileShader() : %s : %s", FileName, ErrorMessage);
-		free(ErrorMessage);
-		glDeleteShader(ShaderID);
-		ShaderID = 0;
+		if (ErrorMessage != NULL)
+		{
+			glGetShaderInfoLog(ShaderID, MaxLength, &MaxLength, ErrorMessage);
+			fprintf(stderr, "ShaderProgram->CompileShader() : %s : %s", FileName, ErrorMessage);
+			free(ErrorMessage);
+		}
 	}
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// With KHR_parallel_shader_compile the driver compiles on its
+// own threads and GL_COMPLETION_STATUS_KHR tells, without
+// blocking, when a program is done.
+
+static int ShaderProgram_HasParallelCompile(void)
+{
+	static int HasParallelCompile = -1;
 	
-	return ShaderID;
+	if (HasParallelCompile == -1)
+	{
+		HasParallelCompile = epoxy_has_gl_extension("GL_KHR_parallel_shader_compile");
+		
+		if (HasParallelCompile)
+		{
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		}
+	}
+	
+	return HasParallelCompile;
 }
 
-char* ShaderProgram_GetProgramName(ShaderProgram* This)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Program binary cache. A binary is only good for the exact
+// sources it was built from and for the driver that built it,
+// so both go into the FNV-1a hash naming the cache file. On any
+// mismatch or rejection, the program is compiled from source
+// and the cache entry rewritten.
+
+#define SHADER_PROGRAM_BINARY_MAGIC 0x43425053u // "SPBC"
+
+typedef struct ShaderProgramBinaryHeader
 {
-	return This->ProgramName; 
+	uint32_t Magic;
+	uint32_t Format;
+	uint64_t Hash;
+	uint32_t Length;
+	uint32_t Reserved;
+} ShaderProgramBinaryHeader;
+
+static char* ShaderProgram_CacheDirectory = NULL;
+
+static uint64_t ShaderProgram_HashString(uint64_t Hash, const char* String)
+{
+	if (String == NULL)
+	{
+		String = "";
+	}
+	
+	for (const unsigned char* Char = (const unsigned char*) String; *Char != 0; Char++)
+	{
+		Hash ^= *Char;
+		Hash *= 0x100000001b3ull;
+	}
+	
+	// Separator, so "ab" + "c" and "a" + "bc" differ.
+	
+	Hash ^= 0xff;
+	Hash *= 0x100000001b3ull;
+	
+	return Hash;
 }
 
-GLuint ShaderProgram_GetProgramID(ShaderProgram* This)
+static uint64_t ShaderProgram_HashSources(ShaderProgram* This, char** SourceCodes, int Count)
 {
-	return This->ProgramID;
+	uint64_t Hash = 0xcbf29ce484222325ull;
+	
+	Hash = ShaderProgram_HashString(Hash, This->ProgramName);
+	Hash = ShaderProgram_HashString(Hash, (const char*) glGetString(GL_VENDOR));
+	Hash = ShaderProgram_HashString(Hash, (const char*) glGetString(GL_RENDERER));
+	Hash = ShaderProgram_HashString(Hash, (const char*) glGetString(GL_VERSION));
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		Hash = ShaderProgram_HashString(Hash, SourceCodes[Index]);
+	}
+	
+	return Hash;
 }
 
-void ShaderProgram_AddUniform(ShaderProgram* This, char* UniformName)
+static char* ShaderProgram_CacheFileName(ShaderProgram* This, uint64_t Hash)
 {
-	This->Uniforms.AddBucket(&This->Uniforms, UniformName, -1);
+	size_t Length = strlen(ShaderProgram_CacheDirectory) + strlen(This->ProgramName) + 32;
+	char* FileName = malloc(Length);
+	
+	if (FileName != NULL)
+	{
+		snprintf(FileName, Length, "%s/%s-%016llx.bin", ShaderProgram_CacheDirectory, This->ProgramName, (unsigned long long) Hash);
+	}
+	
+	return FileName;
 }
 
-void ShaderProgram_CreateComputeShader(ShaderProgram* This, char* SourcePath, char* CSFileName)
+static int ShaderProgram_IsBinaryCacheUsable(void)
 {
-	char* PathFileName = (char*) malloc(sizeof(char) * (strlen(SourcePath) + strlen(CSFileName) + 1));
+	GLint FormatsCount = 0;
 	
-	if (PathFileName == NULL)
+	if (ShaderProgram_CacheDirectory == NULL)
 	{
-		return;
+		return FALSE;
 	}
 	
-	strcpy(PathFileName, SourcePath);
-	strcat(PathFileName, CSFileName);
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &FormatsCount);
+	
+	return FormatsCount > 0;
+}
+
+static int ShaderProgram_LoadBinary(ShaderProgram* This, uint64_t Hash, BindAttribute RemoteBindAttribute)
+{
+	if (ShaderProgram_IsBinaryCacheUsable() == FALSE)
+	{
+		return FALSE;
+	}
 	
-	char* CSSourceCode = ShaderProgram_LoadSource(PathFileName);
-	free(PathFileName);
+	char* FileName = ShaderProgram_CacheFileName(This, Hash);
 	
-	if (CSSourceCode != NULL)
+	if (FileName == NULL)
 	{
-		GLuint ComputeShaderID = ShaderProgram_CompileShader(CSFileName, CSSourceCode, GL_COMPUTE_SHADER);
+		return FALSE;
+	}
+	
+	FILE* Stream = fopen(FileName, "rb");
+	free(FileName);
+	
+	if (Stream == NULL)
+	{
+		return FALSE;
+	}
+	
+	ShaderProgramBinaryHeader Header;
+	void* Binary = NULL;
+	int IsLoaded = FALSE;
+	
+	if (fread(&Header, sizeof(Header), 1, Stream) == 1 && Header.Magic == SHADER_PROGRAM_BINARY_MAGIC && Header.Hash == Hash && Header.Length > 0)
+	{
+		Binary = malloc(Header.Length);
 		
-		if (ComputeShaderID >= 1)
+		if (Binary != NULL && fread(Binary, Header.Length, 1, Stream) == 1)
 		{
 			This->ProgramID = glCreateProgram();
-			glAttachShader(This->ProgramID, ComputeShaderID);
-			glLinkProgram(This->ProgramID);
-			
-			GLint IsProgramLinked;
-			glGetProgramiv(This->ProgramID, GL_LINK_STATUS, &IsProgramLinked);
 			
-			if (IsProgramLinked == FALSE)
-			{				
-				GLint MaxLength;
-				glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-					
-				char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-				
-				glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-				
-				fprintf(stderr, "ShaderProgram->CreateComputeShader() : %s : %s", This->ProgramName, ErrorMessage);
-				free(ErrorMessage);
-				
-				glDetachShader(This->ProgramID, ComputeShaderID);
-				glDeleteShader(ComputeShaderID);
-				glDeleteProgram(This->ProgramID);
-				
-				return;
+			if (RemoteBindAttribute != NULL)
+			{
+				RemoteBindAttribute(This->ProgramID);
 			}
 			
-			glValidateProgram(This->ProgramID);
+			glProgramBinary(This->ProgramID, Header.Format, Binary, Header.Length);
 			
-			GLint IsProgramValid;
-			glGetProgramiv(This->ProgramID, GL_VALIDATE_STATUS, &IsProgramValid);
+			GLint IsProgramLinked;
+			glGetProgramiv(This->ProgramID, GL_LINK_STATUS, &IsProgramLinked);
 			
-			if (IsProgramValid == FALSE)
-			{				
-				GLint MaxLength;
-				glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-					
-				char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-				
-				glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-				
-				fprintf(stderr, "ShaderProgram->CreateComputeShader() : %s : %s", This->ProgramName, ErrorMessage);
-				free(ErrorMessage);
-				
-				glDetachShader(This->ProgramID, ComputeShaderID);
-				glDeleteShader(ComputeShaderID);
-				glDeleteProgram(This->ProgramID);
-				return;	
+			if (IsProgramLinked == TRUE)
+			{
+				IsLoaded = TRUE;
 			}
-			
-			if (This->ProgramID >= 1)
+			else
 			{
-				glDeleteShader(ComputeShaderID);
+				// Typically a driver update, the caller compiles from source.
+				
+				glDeleteProgram(This->ProgramID);
+				This->ProgramID = 0;
 			}
-			
 		}
-		
-		free(CSSourceCode);
 	}
+	
+	free(Binary);
+	fclose(Stream);
+	
+	return IsLoaded;
 }
 
-void ShaderProgram_CreateRenderingShader(ShaderProgram* This, char* SourcePath, char* VSFileName, char* GSFileName, char* FSFileName, BindAttribute RemoteBindAttribute)
+static void ShaderProgram_SaveBinary(ShaderProgram* This, uint64_t Hash)
 {
-	char* VSPathFileName = (char*) malloc(sizeof(char) * (strlen(SourcePath) + strlen(VSFileName) + 1));
-	
-	if (VSPathFileName == NULL)
+	if (ShaderProgram_IsBinaryCacheUsable() == FALSE)
 	{
 		return;
 	}
 	
-	strcpy(VSPathFileName, SourcePath);
-	strcat(VSPathFileName, VSFileName);
-	
-	GLuint VertexShaderID = 0, GeometryShaderID = 0, FragmentShaderID = 0;
-	
-	char* VSSourceCode = ShaderProgram_LoadSource(VSPathFileName);
-	free(VSPathFileName);
+	GLint Length = 0;
+	glGetProgramiv(This->ProgramID, GL_PROGRAM_BINARY_LENGTH, &Length);
 	
-	if (VSSourceCode == NULL)
+	if (Length <= 0)
 	{
-		
 		return;
 	}
 	
-	VertexShaderID = ShaderProgram_CompileShader(VSFileName, VSSourceCode, GL_VERTEX_SHADER);
-	free(VSSourceCode);
+	void* Binary = malloc(Length);
+	char* FileName = ShaderProgram_CacheFileName(This, Hash);
 	
-	if (GSFileName != NULL)
+	if (Binary != NULL && FileName != NULL)
 	{
-		char* GSPathFileName = (char*) malloc(sizeof(char) * (strlen(SourcePath) + strlen(GSFileName) + 1));
+		ShaderProgramBinaryHeader Header = {SHADER_PROGRAM_BINARY_MAGIC, 0, Hash, 0, 0};
+		GLenum Format = 0;
+		GLsizei Written = 0;
 		
-		if (GSPathFileName == NULL)
-		{
-			glDeleteShader(VertexShaderID);
-			return;
-		}
+		glGetProgramBinary(This->ProgramID, Length, &Written, &Format, Binary);
 		
-		strcpy(GSPathFileName, SourcePath);
-		strcat(GSPathFileName, GSFileName);
+		Header.Format = Format;
+		Header.Length = (uint32_t) Written;
 		
-		char* GSSourceCode = ShaderProgram_LoadSource(GSPathFileName);
-		free(GSPathFileName);
+		FILE* Stream = fopen(FileName, "wb");
 		
-		if (GSSourceCode == NULL)
+		if (Stream != NULL)
 		{
-			glDeleteShader(VertexShaderID);
-			return;
+			if (fwrite(&Header, sizeof(Header), 1, Stream) != 1 || fwrite(Binary, Written, 1, Stream) != 1)
+			{
+				fprintf(stderr, "ShaderProgram->SaveBinary() : WriteFile failure ! : %s\n", FileName);
+			}
+			
+			fclose(Stream);
 		}
+	}
+	
+	free(FileName);
+	free(Binary);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The directory must exist. NULL, the default, disables the
+// program binary cache.
+
+void ShaderProgram_SetCacheDirectory(const char* Directory)
+{
+	free(ShaderProgram_CacheDirectory);
+	ShaderProgram_CacheDirectory = Directory != NULL ? strdup(Directory) : NULL;
+}
+
+char* ShaderProgram_GetProgramName(ShaderProgram* This)
+{
+	return This->ProgramName; 
+}
+
+GLuint ShaderProgram_GetProgramID(ShaderProgram* This)
+{
+	return This->ProgramID;
+}
+
+int ShaderProgram_AddUniform(ShaderProgram* This, char* UniformName)
+{
+	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
+	{
+		return This->Uniforms.GetBucketValue(&This->Uniforms);
+	}
+	
+	if (This->UniformsCount == This->UniformsMax)
+	{
+		int UniformsMax = This->UniformsMax * 2;
+		GLint* UniformLocations = realloc(This->UniformLocations, sizeof(GLint) * UniformsMax);
 		
-		GeometryShaderID = ShaderProgram_CompileShader(GSFileName, GSSourceCode, GL_GEOMETRY_SHADER);
-		free(GSSourceCode);
+		if (UniformLocations == NULL)
+		{
+			fprintf(stderr, "ShaderProgram->AddUniform() : UniformLocations allocation failure ! : %s : %s", This->ProgramName, UniformName);
+			return SHADER_UNIFORM_INVALID;
+		}
+		
+		This->UniformLocations = UniformLocations;
+		This->UniformsMax = UniformsMax;
 	}
 	
-	char* FSPathFileName = (char*) malloc(sizeof(char) * (strlen(SourcePath) + strlen(FSFileName) + 1));
+	int Handle = This->UniformsCount++;
 	
-	if (FSPathFileName == NULL)
+	This->UniformLocations[Handle] = -1;
+	This->Uniforms.AddBucket(&This->Uniforms, UniformName, Handle);
+	
+	return Handle;
+}
+
+int ShaderProgram_GetUniform(ShaderProgram* This, char* UniformName)
+{
+	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
 	{
-		return;
+		return This->Uniforms.GetBucketValue(&This->Uniforms);
 	}
 	
-	strcpy(FSPathFileName, SourcePath);
-	strcat(FSPathFileName, FSFileName);
+	return SHADER_UNIFORM_INVALID;
+}
+
+static void ShaderProgram_PrintProgramLog(ShaderProgram* This)
+{
+	GLint MaxLength;
+	glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
 	
-	char* FSSourceCode = ShaderProgram_LoadSource(FSPathFileName);
-	free(FSPathFileName);
+	char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
 	
-	if (FSSourceCode == NULL)
+	if (ErrorMessage != NULL)
 	{
-		if (GeometryShaderID > 0)
-		{
-			glDeleteShader(GeometryShaderID);
-		}
-		
-		glDeleteShader(VertexShaderID);
+		glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
+		fprintf(stderr, "ShaderProgram->LinkProgram() : %s : %s", This->ProgramName, ErrorMessage);
+		free(ErrorMessage);
 	}
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Submits the compilation and the link of the sources, a NULL
+// source is skipped. Nothing waits on the driver here, unless
+// the binary cache has the program already.
+
+static void ShaderProgram_SubmitProgram(ShaderProgram* This, char** FileNames, char** SourceCodes, GLenum* ShaderTypes, int Count, BindAttribute RemoteBindAttribute)
+{
+	This->PendingHash = ShaderProgram_HashSources(This, SourceCodes, Count);
 	
-	FragmentShaderID = ShaderProgram_CompileShader(FSFileName, FSSourceCode, GL_FRAGMENT_SHADER);
+	This->PendingShadersCount = 0;
 	
-	if (VertexShaderID >= 1 && GeometryShaderID == 0 && FragmentShaderID >= 1)
+	if (ShaderProgram_LoadBinary(This, This->PendingHash, RemoteBindAttribute))
 	{
-		This->ProgramID = glCreateProgram();
-		glAttachShader(This->ProgramID, VertexShaderID);
-		glAttachShader(This->ProgramID, FragmentShaderID);
-		
-		if (RemoteBindAttribute != NULL)
+		This->IsPending = TRUE;
+		return;
+	}
+	
+	ShaderProgram_HasParallelCompile();
+	
+	for (int Index = 0; Index < Count; Index++)
+	{
+		if (SourceCodes[Index] != NULL)
 		{
-			RemoteBindAttribute(This->ProgramID);
+			This->PendingFileNames[This->PendingShadersCount] = FileNames[Index];
+			This->PendingShaderIDs[This->PendingShadersCount] = ShaderProgram_CompileShader(SourceCodes[Index], ShaderTypes[Index]);
+			This->PendingShadersCount++;
 		}
-		
-		glLinkProgram(This->ProgramID);
-		
-		GLint IsProgramLinked;
-		glGetProgramiv(This->ProgramID, GL_LINK_STATUS, &IsProgramLinked);
-		
-		if (IsProgramLinked == FALSE)
+	}
+	
+	This->ProgramID = glCreateProgram();
+	
+	for (int Index = 0; Index < This->PendingShadersCount; Index++)
+	{
+		glAttachShader(This->ProgramID, This->PendingShaderIDs[Index]);
+	}
+	
+	if (RemoteBindAttribute != NULL)
+	{
+		RemoteBindAttribute(This->ProgramID);
+	}
+	
+	if (ShaderProgram_CacheDirectory != NULL)
+	{
+		glProgramParameteri(This->ProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	
+	glLinkProgram(This->ProgramID);
+	
+	This->IsPending = TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Collects the result of a submitted program, blocking if the
+// driver is not done yet. Returns TRUE if the program is
+// usable. glValidateProgram() checks the program against the
+// current GL state, which means little at creation time, so it
+// only runs when built with CCOND=-DSHADER_PROGRAM_VALIDATE.
+
+int ShaderProgram_Finish(ShaderProgram* This)
+{
+	if (This->IsPending == FALSE)
+	{
+		return This->ProgramID != 0;
+	}
+	
+	This->IsPending = FALSE;
+	
+	GLint IsProgramValid;
+	glGetProgramiv(This->ProgramID, GL_LINK_STATUS, &IsProgramValid);
+	
+	if (IsProgramValid == FALSE)
+	{
+		for (int Index = 0; Index < This->PendingShadersCount; Index++)
 		{
-			GLint MaxLength;
-			glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-			
-			char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-			
-			glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-			
-			fprintf(stderr, "ShaderProgram->CreateRenderingShader() : %s : %s", This->ProgramName, ErrorMessage);
-			free(ErrorMessage);
-				
-			glDetachShader(This->ProgramID, VertexShaderID);
-			glDetachShader(This->ProgramID, FragmentShaderID);
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(FragmentShaderID);
-			
-			glDeleteProgram(This->ProgramID);
-			
-			return;
+			ShaderProgram_PrintShaderLog(This->PendingFileNames[Index], This->PendingShaderIDs[Index]);
 		}
 		
+		ShaderProgram_PrintProgramLog(This);
+	}
+	
+#if defined(SHADER_PROGRAM_VALIDATE)
+	
+	if (IsProgramValid == TRUE)
+	{
 		glValidateProgram(This->ProgramID);
-		
-		GLint IsProgramValid;
 		glGetProgramiv(This->ProgramID, GL_VALIDATE_STATUS, &IsProgramValid);
 		
 		if (IsProgramValid == FALSE)
 		{
-			GLint MaxLength;
-			glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-					
-			char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-			
-			glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-			
-			fprintf(stderr, "ShaderProgram->CreateRenderingShader() : %s : %s", This->ProgramName, ErrorMessage);
-			free(ErrorMessage);
-			
-			glDetachShader(This->ProgramID, VertexShaderID);
-			glDetachShader(This->ProgramID, FragmentShaderID);
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(FragmentShaderID);
-			glDeleteProgram(This->ProgramID);
-			
-			return;
-		}
-		
-		if (This->ProgramID >= 1)
-		{
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(FragmentShaderID);
+			ShaderProgram_PrintProgramLog(This);
 		}
 	}
-	else if (VertexShaderID >= 1 && GeometryShaderID >= 1 && FragmentShaderID >= 1)
+	
+#endif
+	
+	for (int Index = 0; Index < This->PendingShadersCount; Index++)
 	{
-		This->ProgramID = glCreateProgram();
-		glAttachShader(This->ProgramID, VertexShaderID);
-		glAttachShader(This->ProgramID, GeometryShaderID);
-		glAttachShader(This->ProgramID, FragmentShaderID);
-		
-		if (RemoteBindAttribute != NULL)
-		{
-			RemoteBindAttribute(This->ProgramID);
-		}
-		
-		glLinkProgram(This->ProgramID);
-		
-		GLint IsProgramLinked;
-		glGetProgramiv(This->ProgramID, GL_LINK_STATUS, &IsProgramLinked);
+		glDetachShader(This->ProgramID, This->PendingShaderIDs[Index]);
+		glDeleteShader(This->PendingShaderIDs[Index]);
+	}
+	
+	if (IsProgramValid == FALSE)
+	{
+		glDeleteProgram(This->ProgramID);
+		This->ProgramID = 0;
+		This->PendingShadersCount = 0;
+		return FALSE;
+	}
+	
+	// No shader means the program came from the binary cache.
+	
+	if (This->PendingShadersCount > 0)
+	{
+		ShaderProgram_SaveBinary(This, This->PendingHash);
+	}
+	
+	This->PendingShadersCount = 0;
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Never blocks when the driver compiles in parallel, returns
+// TRUE once Finish() can be called without waiting, or was.
+// Without the extension there is no way to know, so the
+// program is finished right away.
+
+int ShaderProgram_IsReady(ShaderProgram* This)
+{
+	if (This->IsPending == FALSE)
+	{
+		return TRUE;
+	}
+	
+	if (ShaderProgram_HasParallelCompile())
+	{
+		GLint IsCompleted = GL_FALSE;
+		glGetProgramiv(This->ProgramID, GL_COMPLETION_STATUS_KHR, &IsCompleted);
 		
-		if (IsProgramLinked == FALSE)
+		if (IsCompleted == GL_FALSE)
 		{
-			GLint MaxLength;
-			glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-			
-			char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-			
-			glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-			
-			fprintf(stderr, "ShaderProgram->CreateRenderingShader() : %s : %s", This->ProgramName, ErrorMessage);
-			free(ErrorMessage);
-			
-			glDetachShader(This->ProgramID, VertexShaderID);
-			glDetachShader(This->ProgramID, GeometryShaderID);
-			glDetachShader(This->ProgramID, FragmentShaderID);
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(GeometryShaderID);
-			glDeleteShader(FragmentShaderID);
-			
-			glDeleteProgram(This->ProgramID);
-			return;	
+			return FALSE;
 		}
-		
-		glValidateProgram(This->ProgramID);
-		
-		GLint IsProgramValid;
-		glGetProgramiv(This->ProgramID, GL_VALIDATE_STATUS, &IsProgramValid);
-		
-		if (IsProgramValid == FALSE)
+	}
+	
+	return TRUE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The source files are remembered for Reload(), a NULL file
+// name being an unused stage.
+
+static void ShaderProgram_RememberSources(ShaderProgram* This, char* SourcePath, char** FileNames, GLenum* ShaderTypes, BindAttribute RemoteBindAttribute)
+{
+	free(This->SourcePath);
+	This->SourcePath = strdup(SourcePath);
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		free(This->SourceFileNames[Index]);
+		This->SourceFileNames[Index] = FileNames[Index] != NULL ? strdup(FileNames[Index]) : NULL;
+		This->SourceTypes[Index] = ShaderTypes[Index];
+	}
+	
+	This->SourceBindAttribute = RemoteBindAttribute;
+}
+
+static void ShaderProgram_SubmitSources(ShaderProgram* This)
+{
+	char* SourceCodes[SHADER_PROGRAM_STAGES_MAX] = {NULL, NULL, NULL};
+	int LoadedCount = 0;
+	int IsLoaded = This->SourcePath != NULL;
+	
+	This->SourceFiles.RemoveAllBuckets(&This->SourceFiles);
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX && IsLoaded == TRUE; Index++)
+	{
+		if (This->SourceFileNames[Index] != NULL)
 		{
-			GLint MaxLength;
-			glGetProgramiv(This->ProgramID, GL_INFO_LOG_LENGTH, &MaxLength);
-					
-			char* ErrorMessage = malloc(sizeof(char) * (MaxLength + 1));
-			
-			glGetProgramInfoLog(This->ProgramID, MaxLength, &MaxLength, ErrorMessage);
-			
-			fprintf(stderr, "ShaderProgram->CreateRenderingShader() : %s : %s", This->ProgramName, ErrorMessage);
-			free(ErrorMessage);
+			SourceCodes[Index] = ShaderPreprocessor_Process(This->SourcePath, This->SourceFileNames[Index], This->Defines, &This->SourceFiles);
 			
-			glDetachShader(This->ProgramID, VertexShaderID);
-			glDetachShader(This->ProgramID, GeometryShaderID);
-			glDetachShader(This->ProgramID, FragmentShaderID);
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(GeometryShaderID);
-			glDeleteShader(FragmentShaderID);
-			glDeleteProgram(This->ProgramID);
-			return;	
-		}
-		
-		if (This->ProgramID >= 1)
-		{
-			glDeleteShader(VertexShaderID);
-			glDeleteShader(GeometryShaderID);
-			glDeleteShader(FragmentShaderID);
+			if (SourceCodes[Index] == NULL)
+			{
+				IsLoaded = FALSE;
+			}
+			else
+			{
+				LoadedCount++;
+			}
 		}
 	}
+	
+	if (IsLoaded == TRUE && LoadedCount > 0)
+	{
+		ShaderProgram_SubmitProgram(This, This->SourceFileNames, SourceCodes, This->SourceTypes, SHADER_PROGRAM_STAGES_MAX, This->SourceBindAttribute);
+	}
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		free(SourceCodes[Index]);
+	}
+}
+
+void ShaderProgram_SubmitComputeShader(ShaderProgram* This, char* SourcePath, char* CSFileName)
+{
+	char* FileNames[SHADER_PROGRAM_STAGES_MAX] = {CSFileName, NULL, NULL};
+	GLenum ShaderTypes[SHADER_PROGRAM_STAGES_MAX] = {GL_COMPUTE_SHADER, 0, 0};
+	
+	ShaderProgram_RememberSources(This, SourcePath, FileNames, ShaderTypes, NULL);
+	ShaderProgram_SubmitSources(This);
+}
+
+void ShaderProgram_SubmitRenderingShader(ShaderProgram* This, char* SourcePath, char* VSFileName, char* GSFileName, char* FSFileName, BindAttribute RemoteBindAttribute)
+{
+	if (VSFileName == NULL || FSFileName == NULL)
+	{
+		fprintf(stderr, "ShaderProgram->SubmitRenderingShader() : Vertex and fragment shaders are mandatory ! : %s\n", This->ProgramName);
+		return;
+	}
+	
+	char* FileNames[SHADER_PROGRAM_STAGES_MAX] = {VSFileName, GSFileName, FSFileName};
+	GLenum ShaderTypes[SHADER_PROGRAM_STAGES_MAX] = {GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER};
+	
+	ShaderProgram_RememberSources(This, SourcePath, FileNames, ShaderTypes, RemoteBindAttribute);
+	ShaderProgram_SubmitSources(This);
+}
+
+void ShaderProgram_CreateComputeShader(ShaderProgram* This, char* SourcePath, char* CSFileName)
+{
+	ShaderProgram_SubmitComputeShader(This, SourcePath, CSFileName);
+	ShaderProgram_Finish(This);
+}
+
+void ShaderProgram_CreateRenderingShader(ShaderProgram* This, char* SourcePath, char* VSFileName, char* GSFileName, char* FSFileName, BindAttribute RemoteBindAttribute)
+{
+	TRACE_SCOPE("ShaderProgram_CreateRenderingShader");
+	
+	ShaderProgram_SubmitRenderingShader(This, SourcePath, VSFileName, GSFileName, FSFileName, RemoteBindAttribute);
+	ShaderProgram_Finish(This);
 }
 
 void ShaderProgram_GetUniformLocations(ShaderProgram* This)
 {
-	This->Uniforms.ResetBuckets(&This->Uniforms);
+	IntegerHashTableIterator Iterator;
+	
+	IntegerHashTableIterator_Init(&Iterator, &This->Uniforms);
 	
-	while (This->Uniforms.NextBucket(&This->Uniforms))
+	while (IntegerHashTableIterator_Next(&Iterator))
 	{
-		char* UniformName = This->Uniforms.GetBucketKey(&This->Uniforms);
+		char* UniformName = Iterator.Key;
 		GLint UniformLocation = glGetUniformLocation(This->ProgramID, UniformName);
 		
-		if (UniformLocation != -1)
-		{
-			This->Uniforms.UpdateBucket(&This->Uniforms, UniformLocation);
-		}
-		else
+		This->UniformLocations[Iterator.Value] = UniformLocation;
+		
+		if (UniformLocation == -1)
 		{
 			fprintf(stderr, "ShaderProgram->GetUniformLocations() : Impossible to find the uniform ! : %s : %s", This->ProgramName, UniformName);
 		}
@@ -427,81 +621,160 @@ void ShaderProgram_GetUniformLocations(ShaderProgram* This)
 	}
 }
 
-void ShaderProgram_SendUniformMatrix4fv(ShaderProgram* This, char* UniformName, Mat44f* Matrix)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Includes count, the program depends on every file read by
+// the last build.
+
+int ShaderProgram_UsesSourceFile(ShaderProgram* This, const char* FileName)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
+	return This->SourceFiles.LookupBucket(&This->SourceFiles, (char*) FileName);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// To be called before submitting the program, the defines are
+// injected in every stage. Each define is "NAME" or
+// "NAME VALUE". Being part of the sources, they are part of
+// the binary cache hash too.
+
+void ShaderProgram_SetDefines(ShaderProgram* This, char** Defines, int Count)
+{
+	free(This->Defines);
+	This->Defines = ShaderPreprocessor_FormatDefines(Defines, Count);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Rebuilds the program from its source files, the GL context
+// must be current. The old program is only deleted once the
+// new one links, a broken edit leaves it in use. Uniform
+// handles stay valid, their locations are fetched again, but
+// the uniform values have to be sent again by the caller.
+
+int ShaderProgram_Reload(ShaderProgram* This)
+{
+	ShaderProgram_Finish(This);
+	
+	GLuint OldProgramID = This->ProgramID;
+	This->ProgramID = 0;
+	
+	ShaderProgram_SubmitSources(This);
+	
+	if (ShaderProgram_Finish(This) == FALSE)
 	{
-		glUniformMatrix4fv(This->Uniforms.GetBucketValue(&This->Uniforms), 1, GL_FALSE, (float*) Matrix);
+		fprintf(stderr, "ShaderProgram->Reload() : Keeping the previous program ! : %s\n", This->ProgramName);
+		This->ProgramID = OldProgramID;
+		return FALSE;
 	}
-	else
+	
+	if (OldProgramID != 0)
 	{
-		fprintf(stderr, "ShaderProgram->SendUniformMatrix4fv() : Impossible to find the uniform location ! : %s : %s", This->ProgramName, UniformName);
+		glDeleteProgram(OldProgramID);
 	}
+	
+	ShaderProgram_GetUniformLocations(This);
+	
+	return TRUE;
 }
 
-void ShaderProgram_SendUniformVec3fv(ShaderProgram* This, char* UniformName, Vec3f* Vector)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// A location of -1, an uniform optimized away by the driver,
+// is silently ignored by glUniform*().
+
+static GLint ShaderProgram_Location(ShaderProgram* This, int Handle)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
+	if (Handle < 0 || Handle >= This->UniformsCount)
 	{
-		glUniform3fv(This->Uniforms.GetBucketValue(&This->Uniforms), 1, (float*) Vector);
+		return -1;
 	}
+	
+	return This->UniformLocations[Handle];
 }
 
-void ShaderProgram_SendUniformVec2fv(ShaderProgram* This, char* UniformName, Vec2f* Vector)
+void ShaderProgram_SendUniformMatrix4fv(ShaderProgram* This, int Handle, Mat44f* Matrix)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
-	{
-		glUniform2fv(This->Uniforms.GetBucketValue(&This->Uniforms), 1, (float*) Vector);
-	}
+	glUniformMatrix4fv(ShaderProgram_Location(This, Handle), 1, GL_FALSE, (float*) Matrix);
 }
 
-void ShaderProgram_SendUniformCol4fv(ShaderProgram* This, char* UniformName, Col4f* Color)
+void ShaderProgram_SendUniformVec3fv(ShaderProgram* This, int Handle, Vec3f* Vector)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
-	{
-		glUniform4fv(This->Uniforms.GetBucketValue(&This->Uniforms), 1, (float*) Color);
-	}
-	else
-	{
-		fprintf(stderr, "ShaderProgram->SendUniformCol4fv() : Impossible to find the uniform location ! : %s : %s", This->ProgramName, UniformName);
-	}
+	glUniform3fv(ShaderProgram_Location(This, Handle), 1, (float*) Vector);
 }
 
-void ShaderProgram_SendUniformCol3fv(ShaderProgram* This, char* UniformName, Col3f* Color)
+void ShaderProgram_SendUniformVec2fv(ShaderProgram* This, int Handle, Vec2f* Vector)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
-	{
-		glUniform3fv(This->Uniforms.GetBucketValue(&This->Uniforms), 1, (float*) Color);
-	}
+	glUniform2fv(ShaderProgram_Location(This, Handle), 1, (float*) Vector);
 }
 
-void ShaderProgram_SendUniform1i(ShaderProgram* This, char* UniformName, GLint Value)
+void ShaderProgram_SendUniformCol4fv(ShaderProgram* This, int Handle, Col4f* Color)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
-	{
-		glUniform1i(This->Uniforms.GetBucketValue(&This->Uniforms), Value);
-	}
+	glUniform4fv(ShaderProgram_Location(This, Handle), 1, (float*) Color);
 }
 
-void ShaderProgram_SendUniform1f(ShaderProgram* This, char* UniformName, GLfloat Value)
+void ShaderProgram_SendUniformCol3fv(ShaderProgram* This, int Handle, Col3f* Color)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
-	{
-		glUniform1f(This->Uniforms.GetBucketValue(&This->Uniforms), Value);
-	}
+	glUniform3fv(ShaderProgram_Location(This, Handle), 1, (float*) Color);
 }
 
-void ShaderProgram_SendUniform1iv(ShaderProgram* This, char* UniformName, GLint* Values, GLsizei Size)
+void ShaderProgram_SendUniform1i(ShaderProgram* This, int Handle, GLint Value)
 {
-	if (This->Uniforms.LookupBucket(&This->Uniforms, UniformName))
+	glUniform1i(ShaderProgram_Location(This, Handle), Value);
+}
+
+void ShaderProgram_SendUniform1f(ShaderProgram* This, int Handle, GLfloat Value)
+{
+	glUniform1f(ShaderProgram_Location(This, Handle), Value);
+}
+
+void ShaderProgram_SendUniform1iv(ShaderProgram* This, int Handle, GLint* Values, GLsizei Size)
+{
+	glUniform1iv(ShaderProgram_Location(This, Handle), Size, Values);
+}
+
+void ShaderProgram_Wipeout(ShaderProgram* This)
+{
+	// Releases the shader objects of a program never collected.
+	
+	ShaderProgram_Finish(This);
+	
+	if (This->ProgramID != 0)
 	{
-		glUniform1iv(This->Uniforms.GetBucketValue(&This->Uniforms), Size, Values);
+		glDeleteProgram(This->ProgramID);
+		This->ProgramID = 0;
+	}
+	
+	// The handles stay, their locations are fetched again by the next link.
+	
+	for (int Handle = 0; Handle < This->UniformsCount; Handle++)
+	{
+		This->UniformLocations[Handle] = -1;
+	}
+	
+	free(This->SourcePath);
+	This->SourcePath = NULL;
+	
+	This->SourceFiles.RemoveAllBuckets(&This->SourceFiles);
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		free(This->SourceFileNames[Index]);
+		This->SourceFileNames[Index] = NULL;
 	}
 }
 
-void ShaderProgram_Wipeout(ShaderProgram* This)
+void ShaderProgram_Destroy(ShaderProgram* This)
 {
+	ShaderProgram_Wipeout(This);
+	
 	This->Uniforms.Wipeout(&This->Uniforms);
+	
+	free(This->UniformLocations);
+	This->UniformLocations = NULL;
+	This->UniformsCount = 0;
+	This->UniformsMax = 0;
+	
+	free(This->Defines);
+	This->Defines = NULL;
+	
+	This->SourceFiles.Wipeout(&This->SourceFiles);
 }
 
 void ShaderProgram_Init(ShaderProgram* This, char* ProgramName)
@@ -509,8 +782,16 @@ void ShaderProgram_Init(ShaderProgram* This, char* ProgramName)
 	This->GetProgramName = ShaderProgram_GetProgramName;
 	This->GetProgramID = ShaderProgram_GetProgramID;
 	This->AddUniform = ShaderProgram_AddUniform;
+	This->GetUniform = ShaderProgram_GetUniform;
 	This->CreateComputeShader = ShaderProgram_CreateComputeShader;
 	This->CreateRenderingShader = ShaderProgram_CreateRenderingShader;
+	This->SubmitComputeShader = ShaderProgram_SubmitComputeShader;
+	This->SubmitRenderingShader = ShaderProgram_SubmitRenderingShader;
+	This->IsReady = ShaderProgram_IsReady;
+	This->Finish = ShaderProgram_Finish;
+	This->SetDefines = ShaderProgram_SetDefines;
+	This->UsesSourceFile = ShaderProgram_UsesSourceFile;
+	This->Reload = ShaderProgram_Reload;
 	This->GetUniformLocations = ShaderProgram_GetUniformLocations;
 	This->SendUniformMatrix4fv = ShaderProgram_SendUniformMatrix4fv;
 	This->SendUniformVec3fv = ShaderProgram_SendUniformVec3fv;
@@ -521,9 +802,35 @@ void ShaderProgram_Init(ShaderProgram* This, char* ProgramName)
 	This->SendUniform1f = ShaderProgram_SendUniform1f;
 	This->SendUniform1iv = ShaderProgram_SendUniform1iv;
 	This->Wipeout  = ShaderProgram_Wipeout;
+	This->Destroy = ShaderProgram_Destroy;
 	
 	This->ProgramName = ProgramName;
+	This->ProgramID = 0;
+	This->IsPending = FALSE;
+	This->PendingShadersCount = 0;
+	This->PendingHash = 0;
+	
+	This->SourcePath = NULL;
+	This->SourceBindAttribute = NULL;
+	This->Defines = NULL;
+	IntegerHashTable_Init(&This->SourceFiles, 16);
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		This->SourceFileNames[Index] = NULL;
+		This->SourceTypes[Index] = 0;
+	}
+	
 	IntegerHashTable_Init(&This->Uniforms, 32);
+	
+	This->UniformsCount = 0;
+	This->UniformsMax = 8;
+	This->UniformLocations = malloc(sizeof(GLint) * This->UniformsMax);
+	
+	if (This->UniformLocations == NULL)
+	{
+		exit(EXIT_FAILURE);
+	}
 }
 
 
@@ -24,6 +24,7 @@
 #ifndef SHADER_PROGRAM_H
 #define SHADER_PROGRAM_H
 
+#include <stdint.h>
 #include <epoxy/gl.h>
 
 #include "IntegerHashTable.h"
@@ -43,6 +44,26 @@
 
 typedef void (*BindAttribute)(GLuint);
 
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// AddUniform() returns the handle of the uniform, an index in
+// UniformLocations staying valid for the life of the program.
+// The Send methods take that handle, the names are only hashed
+// at initialization time. Wipeout() only releases the GL side
+// and the sources, the handles and the defines survive it for
+// a new GL context. Destroy() frees them as well.
+//
+// Create*Shader() compile and link before returning. The
+// Submit*Shader() variants return at once, IsReady() then
+// polls without blocking and Finish() collects the result,
+// letting many programs compile in parallel. The source
+// files are remembered, Reload() rebuilds the program from
+// them and keeps the previous one if the edit does not link.
+// The sources go through ShaderPreprocessor, which resolves
+// the #include and injects the SetDefines() block.
+
+#define SHADER_UNIFORM_INVALID -1
+#define SHADER_PROGRAM_STAGES_MAX 3
+
 typedef struct ShaderProgram ShaderProgram;
 
 struct ShaderProgram
@@ -50,24 +71,56 @@ struct ShaderProgram
 	char* ProgramName;
 	GLuint ProgramID;
 	IntegerHashTable Uniforms;
+	GLint* UniformLocations;
+	int UniformsCount;
+	int UniformsMax;
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// A submitted program waiting for Finish()
+	
+	int IsPending;
+	GLuint PendingShaderIDs[SHADER_PROGRAM_STAGES_MAX];
+	char* PendingFileNames[SHADER_PROGRAM_STAGES_MAX];
+	int PendingShadersCount;
+	uint64_t PendingHash;
+	
+	// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+	// Where the program comes from, for Reload()
+	
+	char* SourcePath;
+	char* SourceFileNames[SHADER_PROGRAM_STAGES_MAX];
+	GLenum SourceTypes[SHADER_PROGRAM_STAGES_MAX];
+	BindAttribute SourceBindAttribute;
+	char* Defines;
+	IntegerHashTable SourceFiles;
 	
 	char* (*GetProgramName)(ShaderProgram*);
 	GLuint (*GetProgramID)(ShaderProgram*);
-	void (*AddUniform)(ShaderProgram*, char*);
+	int (*AddUniform)(ShaderProgram*, char*);
+	int (*GetUniform)(ShaderProgram*, char*);
 	void (*CreateComputeShader)(ShaderProgram*, char*, char*);
 	void (*CreateRenderingShader)(ShaderProgram*, char*, char*, char*, char*, BindAttribute);
+	void (*SubmitComputeShader)(ShaderProgram*, char*, char*);
+	void (*SubmitRenderingShader)(ShaderProgram*, char*, char*, char*, char*, BindAttribute);
+	int (*IsReady)(ShaderProgram*);
+	int (*Finish)(ShaderProgram*);
+	void (*SetDefines)(ShaderProgram*, char**, int);
+	int (*UsesSourceFile)(ShaderProgram*, const char*);
+	int (*Reload)(ShaderProgram*);
 	void (*GetUniformLocations)(ShaderProgram*);
-	void (*SendUniformMatrix4fv)(ShaderProgram*, char*, Mat44f*);
-	void (*SendUniformVec3fv)(ShaderProgram*, char*, Vec3f*);
-	void (*SendUniformVec2fv)(ShaderProgram*, char*, Vec2f*);
-	void (*SendUniformCol4fv)(ShaderProgram*, char*, Col4f*);
-	void (*SendUniformCol3fv)(ShaderProgram*, char*, Col3f*);
-	void (*SendUniform1i)(ShaderProgram*, char*, GLint);
-	void (*SendUniform1f)(ShaderProgram*, char*, GLfloat);
-	void (*SendUniform1iv)(ShaderProgram*, char*, GLint*, GLsizei);
+	void (*SendUniformMatrix4fv)(ShaderProgram*, int, Mat44f*);
+	void (*SendUniformVec3fv)(ShaderProgram*, int, Vec3f*);
+	void (*SendUniformVec2fv)(ShaderProgram*, int, Vec2f*);
+	void (*SendUniformCol4fv)(ShaderProgram*, int, Col4f*);
+	void (*SendUniformCol3fv)(ShaderProgram*, int, Col3f*);
+	void (*SendUniform1i)(ShaderProgram*, int, GLint);
+	void (*SendUniform1f)(ShaderProgram*, int, GLfloat);
+	void (*SendUniform1iv)(ShaderProgram*, int, GLint*, GLsizei);
 	void (*Wipeout)(ShaderProgram*);
+	void (*Destroy)(ShaderProgram*);
 };
 
+void ShaderProgram_SetCacheDirectory(const char*);
 void ShaderProgram_Init(ShaderProgram*, char*);
 
 
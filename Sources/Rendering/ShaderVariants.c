@@ -0,0 +1,196 @@
+/*
+ * ShaderVariants.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ShaderPreprocessor.h"
+#include "ShaderVariants.h"
+
+void ShaderVariants_SetSources(ShaderVariants* This, char* SourcePath, char* VSFileName, char* GSFileName, char* FSFileName, BindAttribute RemoteBindAttribute)
+{
+	char* FileNames[SHADER_PROGRAM_STAGES_MAX] = {VSFileName, GSFileName, FSFileName};
+	
+	free(This->SourcePath);
+	This->SourcePath = strdup(SourcePath);
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		free(This->FileNames[Index]);
+		This->FileNames[Index] = FileNames[Index] != NULL ? strdup(FileNames[Index]) : NULL;
+	}
+	
+	This->RemoteBindAttribute = RemoteBindAttribute;
+}
+
+int ShaderVariants_AddUniform(ShaderVariants* This, char* UniformName)
+{
+	if (This->UniformsCount == This->UniformsMax)
+	{
+		int UniformsMax = This->UniformsMax > 0 ? This->UniformsMax * 2 : 8;
+		char** UniformNames = realloc(This->UniformNames, sizeof(char*) * UniformsMax);
+		
+		if (UniformNames == NULL)
+		{
+			fprintf(stderr, "ShaderVariants->AddUniform() : UniformNames allocation failure ! : %s : %s\n", This->ProgramName, UniformName);
+			return SHADER_UNIFORM_INVALID;
+		}
+		
+		This->UniformNames = UniformNames;
+		This->UniformsMax = UniformsMax;
+	}
+	
+	This->UniformNames[This->UniformsCount] = strdup(UniformName);
+	
+	return This->UniformsCount++;
+}
+
+SLOT_MAP_DEFINE(ShaderProgramSlots, ShaderProgram)
+GENERIC_HASH_MAP_DEFINE(ShaderVariantKeys, const char*, SlotMapHandle, GenericHashMap_HashString, GENERIC_HASH_MAP_EQUALS_STRING)
+
+static SlotMapHandle ShaderVariants_NewVariant(ShaderVariants* This, char** Defines, int Count)
+{
+	ShaderProgram Program;
+	
+	ShaderProgram_Init(&Program, This->ProgramName);
+	
+	for (int Index = 0; Index < This->UniformsCount; Index++)
+	{
+		Program.AddUniform(&Program, This->UniformNames[Index]);
+	}
+	
+	Program.SetDefines(&Program, Defines, Count);
+	
+	if (Program.Defines == NULL)
+	{
+		Program.Destroy(&Program);
+		return SlotMapHandle_Invalid;
+	}
+	
+	Program.SubmitRenderingShader(&Program, This->SourcePath, This->FileNames[0], This->FileNames[1], This->FileNames[2], This->RemoteBindAttribute);
+	
+	SlotMapHandle Handle = ShaderProgramSlots_Add(&This->Programs, &Program);
+	
+	ShaderVariantKeys_Insert(&This->Keys, Program.Defines, Handle);
+	
+	return Handle;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Returns an invalid handle only on allocation failure. A new
+// variant is only submitted, see ShaderProgram for IsReady()
+// and Finish().
+
+SlotMapHandle ShaderVariants_GetVariant(ShaderVariants* This, char** Defines, int Count)
+{
+	char* Key = ShaderPreprocessor_FormatDefines(Defines, Count);
+	
+	if (Key == NULL)
+	{
+		return SlotMapHandle_Invalid;
+	}
+	
+	SlotMapHandle* Handle = ShaderVariantKeys_Lookup(&This->Keys, Key);
+	SlotMapHandle Variant = Handle != NULL ? *Handle : ShaderVariants_NewVariant(This, Defines, Count);
+	
+	free(Key);
+	
+	return Variant;
+}
+
+ShaderProgram* ShaderVariants_Get(ShaderVariants* This, SlotMapHandle Handle)
+{
+	return ShaderProgramSlots_Get(&This->Programs, Handle);
+}
+
+int ShaderVariants_HasPending(ShaderVariants* This)
+{
+	for (uint32_t Index = 0; Index < This->Programs.Count; Index++)
+	{
+		if (This->Programs.Data[Index].IsPending)
+		{
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+int ShaderVariants_UsesSourceFile(ShaderVariants* This, const char* FileName)
+{
+	for (uint32_t Index = 0; Index < This->Programs.Count; Index++)
+	{
+		ShaderProgram* Program = &This->Programs.Data[Index];
+		
+		if (Program->UsesSourceFile(Program, FileName))
+		{
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Only the programs go away, the sources and the uniform names
+// stay for a new GL context.
+
+void ShaderVariants_Wipeout(ShaderVariants* This)
+{
+	ShaderVariantKeys_Clear(&This->Keys);
+	
+	for (uint32_t Index = 0; Index < This->Programs.Count; Index++)
+	{
+		This->Programs.Data[Index].Destroy(&This->Programs.Data[Index]);
+	}
+	
+	ShaderProgramSlots_Clear(&This->Programs);
+}
+
+void ShaderVariants_Init(ShaderVariants* This, char* ProgramName)
+{
+	This->SetSources = ShaderVariants_SetSources;
+	This->AddUniform = ShaderVariants_AddUniform;
+	This->GetVariant = ShaderVariants_GetVariant;
+	This->Get = ShaderVariants_Get;
+	This->HasPending = ShaderVariants_HasPending;
+	This->UsesSourceFile = ShaderVariants_UsesSourceFile;
+	This->Wipeout = ShaderVariants_Wipeout;
+	
+	This->ProgramName = ProgramName;
+	This->SourcePath = NULL;
+	This->RemoteBindAttribute = NULL;
+	
+	for (int Index = 0; Index < SHADER_PROGRAM_STAGES_MAX; Index++)
+	{
+		This->FileNames[Index] = NULL;
+	}
+	
+	ShaderVariantKeys_Init(&This->Keys, 8);
+	ShaderProgramSlots_Init(&This->Programs, 4);
+	
+	This->UniformNames = NULL;
+	This->UniformsCount = 0;
+	This->UniformsMax = 0;
+}
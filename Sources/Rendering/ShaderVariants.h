@@ -0,0 +1,73 @@
+/*
+ * ShaderVariants.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "GenericHashMap.h"
+#include "SlotMap.h"
+#include "ShaderProgram.h"
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The specialized permutations of one set of source files,
+// keyed by their define set. GetVariant() submits a variant
+// the first time its define set is asked for, then returns
+// the handle of the same program. Every variant registers the
+// uniforms in the AddUniform() order, so a uniform handle is
+// good for all of them.
+//
+// The programs are packed in a slot map, a ShaderProgram*
+// from Get() must not be kept across a GetVariant() call.
+// The keys are the define blocks owned by the programs.
+
+SLOT_MAP_DECLARE(ShaderProgramSlots, ShaderProgram)
+GENERIC_HASH_MAP_DECLARE(ShaderVariantKeys, const char*, SlotMapHandle)
+
+typedef struct ShaderVariants ShaderVariants;
+
+struct ShaderVariants
+{
+	char* ProgramName;
+	char* SourcePath;
+	char* FileNames[SHADER_PROGRAM_STAGES_MAX];
+	BindAttribute RemoteBindAttribute;
+	
+	ShaderVariantKeys Keys;
+	ShaderProgramSlots Programs;
+	
+	char** UniformNames;
+	int UniformsCount;
+	int UniformsMax;
+	
+	void (*SetSources)(ShaderVariants*, char*, char*, char*, char*, BindAttribute);
+	int (*AddUniform)(ShaderVariants*, char*);
+	SlotMapHandle (*GetVariant)(ShaderVariants*, char**, int);
+	ShaderProgram* (*Get)(ShaderVariants*, SlotMapHandle);
+	int (*HasPending)(ShaderVariants*);
+	int (*UsesSourceFile)(ShaderVariants*, const char*);
+	void (*Wipeout)(ShaderVariants*);
+};
+
+void ShaderVariants_Init(ShaderVariants*, char*);
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * Trace.c
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifdef TRACE_ENABLED
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Trace.h"
+
+typedef struct TraceEvent
+{
+	const char* Name;
+	uint64_t Begin;
+	uint64_t Duration;
+} TraceEvent;
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Only the owner thread writes a ring. It fills the event
+// then publishes it by moving Head with a release store. The
+// rings are pushed on a list that never shrinks, a thread
+// leaving keeps its events for the next dump.
+
+typedef struct TraceRing TraceRing;
+
+struct TraceRing
+{
+	TraceRing* Next;
+	int ThreadID;
+	_Atomic uint64_t Head;
+	TraceEvent Events[TRACE_RING_EVENTS];
+};
+
+static _Atomic(TraceRing*) TraceRings = NULL;
+static atomic_int TraceThreadCount = 0;
+static __thread TraceRing* TraceThreadRing = NULL;
+
+static pthread_mutex_t TraceDumpLock = PTHREAD_MUTEX_INITIALIZER;
+static char* TracePath = NULL;
+
+static uint64_t Trace_Now(void)
+{
+	struct timespec Time;
+	
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	
+	return (uint64_t) Time.tv_sec * 1000000000u + (uint64_t) Time.tv_nsec;
+}
+
+static TraceRing* Trace_GetThreadRing(void)
+{
+	if (TraceThreadRing == NULL)
+	{
+		TraceRing* Ring = calloc(1, sizeof(TraceRing));
+		
+		if (Ring == NULL)
+		{
+			fprintf(stderr, "Trace_GetThreadRing() : Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		
+		Ring->ThreadID = atomic_fetch_add(&TraceThreadCount, 1) + 1;
+		Ring->Next = atomic_load(&TraceRings);
+		
+		while (!atomic_compare_exchange_weak(&TraceRings, &Ring->Next, Ring))
+		{
+		}
+		
+		TraceThreadRing = Ring;
+	}
+	
+	return TraceThreadRing;
+}
+
+TraceScope Trace_BeginScope(const char* Name)
+{
+	TraceScope Scope = {.Name = Name, .Begin = Trace_Now()};
+	
+	return Scope;
+}
+
+void Trace_EndScope(TraceScope* Scope)
+{
+	uint64_t End = Trace_Now();
+	TraceRing* Ring = Trace_GetThreadRing();
+	uint64_t Head = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+	TraceEvent* Event = &Ring->Events[Head % TRACE_RING_EVENTS];
+	
+	Event->Name = Scope->Name;
+	Event->Begin = Scope->Begin;
+	Event->Duration = End - Scope->Begin;
+	
+	atomic_store_explicit(&Ring->Head, Head + 1, memory_order_release);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// The rings are read while their threads keep writing. An
+// event copied from a slot the owner reused during the copy is
+// dropped, that is the oldest ones, found by reading Head again
+// after the copy.
+
+static size_t Trace_CopyRing(TraceRing* Ring, TraceEvent* Events)
+{
+	uint64_t Head = atomic_load_explicit(&Ring->Head, memory_order_acquire);
+	uint64_t First = Head > TRACE_RING_EVENTS ? Head - TRACE_RING_EVENTS : 0;
+	
+	for (uint64_t Index = First; Index < Head; Index++)
+	{
+		Events[Index - First] = Ring->Events[Index % TRACE_RING_EVENTS];
+	}
+	
+	atomic_thread_fence(memory_order_acquire);
+	
+	// The owner may already be filling the slot of event NewHead, not published yet.
+	
+	uint64_t NewHead = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+	uint64_t Overwritten = NewHead + 1 > TRACE_RING_EVENTS ? NewHead + 1 - TRACE_RING_EVENTS : 0;
+	
+	if (Overwritten >= Head)
+	{
+		return 0;
+	}
+	
+	size_t Skip = Overwritten > First ? (size_t) (Overwritten - First) : 0;
+	
+	memmove(Events, Events + Skip, (size_t) (Head - First - Skip) * sizeof(TraceEvent));
+	
+	return (size_t) (Head - First - Skip);
+}
+
+void Trace_Dump(void)
+{
+	pthread_mutex_lock(&TraceDumpLock);
+	
+	if (TracePath == NULL)
+	{
+		pthread_mutex_unlock(&TraceDumpLock);
+		return;
+	}
+	
+	FILE* File = fopen(TracePath, "w");
+	
+	if (File == NULL)
+	{
+		fprintf(stderr, "Trace_Dump() : Could not open %s\n", TracePath);
+		pthread_mutex_unlock(&TraceDumpLock);
+		return;
+	}
+	
+	TraceEvent* Events = malloc(TRACE_RING_EVENTS * sizeof(TraceEvent));
+	
+	if (Events == NULL)
+	{
+		fprintf(stderr, "Trace_Dump() : Memory allocation failed\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	int ProcessID = (int) getpid();
+	const char* Separator = "";
+	
+	fprintf(File, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	
+	for (TraceRing* Ring = atomic_load(&TraceRings); Ring != NULL; Ring = Ring->Next)
+	{
+		size_t Count = Trace_CopyRing(Ring, Events);
+		
+		for (size_t Index = 0; Index < Count; Index++)
+		{
+			fprintf(File, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", Separator, Events[Index].Name, Events[Index].Begin / 1000.0, Events[Index].Duration / 1000.0, ProcessID, Ring->ThreadID);
+			Separator = ",";
+		}
+	}
+	
+	fprintf(File, "\n]}\n");
+	fclose(File);
+	free(Events);
+	
+	pthread_mutex_unlock(&TraceDumpLock);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Nothing can be written from a signal handler, so SIGUSR1 is
+// blocked in every thread and a thread of ours waits for it.
+// The threads created later inherit the mask.
+
+static void* Trace_SignalThread(void* Data)
+{
+	sigset_t* Signals = (sigset_t*) Data;
+	int Signal;
+	
+	while (sigwait(Signals, &Signal) == 0)
+	{
+		Trace_Dump();
+	}
+	
+	return NULL;
+}
+
+void Trace_Init(const char* Path)
+{
+	static sigset_t Signals;
+	pthread_t SignalThread;
+	
+	pthread_mutex_lock(&TraceDumpLock);
+	
+	if (TracePath != NULL)
+	{
+		pthread_mutex_unlock(&TraceDumpLock);
+		return;
+	}
+	
+	TracePath = strdup(Path);
+	
+	pthread_mutex_unlock(&TraceDumpLock);
+	
+	sigemptyset(&Signals);
+	sigaddset(&Signals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &Signals, NULL);
+	
+	if (pthread_create(&SignalThread, NULL, Trace_SignalThread, &Signals) == 0)
+	{
+		pthread_detach(SignalThread);
+	}
+	
+	atexit(Trace_Dump);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Trace.h
+ * 
+ * Copyright 2025 Guillaume Saumure <gsaumure@cgocable.ca>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ * 
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Scoped timeline markers, written as Chrome trace_event JSON
+// (chrome://tracing, ui.perfetto.dev). Built with
+// make CCOND=-DTRACE_ENABLED, every macro below compiles to
+// nothing otherwise.
+//
+// TRACE_SCOPE(Name) times the rest of the enclosing block, Name
+// must be a string literal, only its address is recorded. Each
+// thread writes into its own ring of the last TRACE_RING_EVENTS
+// events, without locks. TRACE_INIT(Path) dumps every ring into
+// Path when the process gets SIGUSR1 and at exit, it must run
+// before any other thread is created.
+
+#define TRACE_RING_EVENTS 65536
+
+#ifdef TRACE_ENABLED
+
+typedef struct TraceScope TraceScope;
+
+struct TraceScope
+{
+	const char* Name;
+	uint64_t Begin;
+};
+
+void Trace_Init(const char* Path);
+void Trace_Dump(void);
+TraceScope Trace_BeginScope(const char* Name);
+void Trace_EndScope(TraceScope* Scope);
+
+#define TRACE_CONCAT_(A, B) A##B
+#define TRACE_CONCAT(A, B) TRACE_CONCAT_(A, B)
+
+#define TRACE_INIT(Path) Trace_Init(Path)
+#define TRACE_DUMP() Trace_Dump()
+#define TRACE_SCOPE(Name) TraceScope TRACE_CONCAT(TraceScope_, __LINE__) __attribute__((cleanup(Trace_EndScope))) = Trace_BeginScope(Name)
+
+#else
+
+#define TRACE_INIT(Path) ((void) 0)
+#define TRACE_DUMP() ((void) 0)
+#define TRACE_SCOPE(Name) ((void) 0)
+
+#endif
+
+#endif
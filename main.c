@@ -22,11 +22,16 @@
  */
 
 #include "Demo.h"
+#include "Trace.h"
 
 Demo MultiGLViewDemo;
 
 int main(int argc, char **argv)
 {
+	// Built with -DTRACE_ENABLED, kill -USR1 or quitting writes the timeline.
+	
+	TRACE_INIT("multi-gl-view-trace.json");
+	
 	Demo_Init(&MultiGLViewDemo);
 	return Demo_Run(&MultiGLViewDemo, argc, argv);
 }
@@ -0,0 +1,12 @@
+// Must match CameraBlock in CameraUniformBuffer.h, std140 and 512 bytes
+
+struct Camera
+{
+    mat4 ProjectionMatrix;
+    mat4 ViewMatrix;
+    mat4 InvProjectionMatrix;
+    mat4 InvViewMatrix;
+    vec4 Viewport;   // 0, 0, width, height
+    ivec4 PlaneID;   // x: 0: X-Z, 1: X-Y, 2: Y-Z
+    vec4 Padding[14];
+};
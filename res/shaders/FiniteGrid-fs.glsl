@@ -2,11 +2,18 @@
 
 in vec3 WorldPos;
 
+// 0: X-Z, 1: X-Y, 2: Y-Z, a constant in the per plane variants
+
+#ifdef PLANE_ID
+const int PlaneID = PLANE_ID;
+#else
+flat in int PlaneID;
+#endif
+
 layout (location=0) out vec4 FragColor;
 layout (location=1) out vec4 BrightColor;
 
 uniform float GridSize;
-uniform int PlaneID;          // 0: X-Z, 1: X-Y, 2: Y-Z
 uniform float GridCellSize;   // Grid spacing
 uniform float MajorLineSpacing = 5.0; // Draw a thick line every N cells
 uniform vec4 GridColorThin = vec4(0.5, 0.5, 0.5, 1.0);
@@ -1,12 +1,22 @@
 #version 330
 
+#include "Camera.glsl"
+#include "FiniteGridPlane.glsl"
+
+// The camera of this view, bound by range
+
+layout (std140) uniform CameraBlock
+{
+    Camera Cam;
+};
+
 out vec3 WorldPos;
 
-uniform mat4 ProjectionMatrix; // Projection matrix for this view
-uniform mat4 ViewMatrix; // View matrix for this view
+#ifndef PLANE_ID
+flat out int PlaneID;
+#endif
 
 uniform float GridSize;
-uniform int PlaneID;       // 0: X-Z, 1: X-Y, 2: Y-Z
 
 const vec3 Pos[4] = vec3[4](
     vec3(-1.0, 0.0, -1.0), // Bottom left
@@ -19,23 +29,14 @@ const int Indices[6] = int[6](0, 2, 1, 2, 0, 3);
 
 void main() {
     int Index = Indices[gl_VertexID];
-    vec3 vPos3 = Pos[Index];
-    vec3 worldPos;
-
-    if (PlaneID == 0) { // X-Z
-        worldPos.x = mix(-GridSize, GridSize, (vPos3.x + 1.0) * 0.5);
-        worldPos.y = 0.0;
-        worldPos.z = mix(-GridSize, GridSize, (vPos3.z + 1.0) * 0.5);
-    } else if (PlaneID == 1) { // X-Y
-        worldPos.x = mix(-GridSize, GridSize, (vPos3.x + 1.0) * 0.5);
-        worldPos.y = mix(-GridSize, GridSize, (vPos3.z + 1.0) * 0.5);
-        worldPos.z = 0.0;
-    } else if (PlaneID == 2) { // Y-Z
-        worldPos.x = 0.0;
-        worldPos.y = mix(-GridSize, GridSize, (vPos3.x + 1.0) * 0.5);
-        worldPos.z = mix(-GridSize, GridSize, (vPos3.z + 1.0) * 0.5);
-    }
-
-    gl_Position = ProjectionMatrix * ViewMatrix * vec4(worldPos, 1.0);
+
+#ifdef PLANE_ID
+    vec3 worldPos = GridWorldPosition(PLANE_ID, Pos[Index], GridSize);
+#else
+    PlaneID = Cam.PlaneID.x;
+    vec3 worldPos = GridWorldPosition(PlaneID, Pos[Index], GridSize);
+#endif
+
+    gl_Position = Cam.ProjectionMatrix * Cam.ViewMatrix * vec4(worldPos, 1.0);
     WorldPos = worldPos;
 }
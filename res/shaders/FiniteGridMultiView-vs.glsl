@@ -0,0 +1,44 @@
+#version 410
+#extension GL_ARB_shader_viewport_layer_array : require
+
+// One instance per view, each one routed to its own viewport of the atlas.
+
+#define MULTI_VIEW_MAX 5
+#define VIEW_MAX 7
+
+#include "Camera.glsl"
+#include "FiniteGridPlane.glsl"
+
+// Every camera, instance N draws with Cameras[ViewNames[N]]
+
+layout (std140) uniform CameraBlock
+{
+    Camera Cameras[VIEW_MAX];
+};
+
+out vec3 WorldPos;
+flat out int PlaneID;
+
+uniform float GridSize;
+uniform int ViewNames[MULTI_VIEW_MAX];
+
+const vec3 Pos[4] = vec3[4](
+    vec3(-1.0, 0.0, -1.0), // Bottom left
+    vec3( 1.0, 0.0, -1.0), // Bottom right
+    vec3( 1.0, 0.0,  1.0), // Top right
+    vec3(-1.0, 0.0,  1.0)  // Top left
+);
+
+const int Indices[6] = int[6](0, 2, 1, 2, 0, 3);
+
+void main() {
+    int View = ViewNames[gl_InstanceID];
+    int Index = Indices[gl_VertexID];
+
+    PlaneID = Cameras[View].PlaneID.x;
+    vec3 worldPos = GridWorldPosition(PlaneID, Pos[Index], GridSize);
+
+    gl_Position = Cameras[View].ProjectionMatrix * Cameras[View].ViewMatrix * vec4(worldPos, 1.0);
+    gl_ViewportIndex = gl_InstanceID;
+    WorldPos = worldPos;
+}
@@ -0,0 +1,16 @@
+// Plane of the grid, 0: X-Z, 1: X-Y, 2: Y-Z. A variant built with
+// PLANE_ID has it as a constant and every branch on it folds away,
+// otherwise it comes per view from the camera.
+
+vec3 GridWorldPosition(int Plane, vec3 Pos, float Size)
+{
+    vec2 Span = vec2(mix(-Size, Size, (Pos.x + 1.0) * 0.5), mix(-Size, Size, (Pos.z + 1.0) * 0.5));
+
+    if (Plane == 0) { // X-Z
+        return vec3(Span.x, 0.0, Span.y);
+    } else if (Plane == 1) { // X-Y
+        return vec3(Span.x, Span.y, 0.0);
+    }
+
+    return vec3(0.0, Span.x, Span.y); // Y-Z
+}